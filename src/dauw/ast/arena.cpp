@@ -0,0 +1,54 @@
+#include "arena.hpp"
+
+namespace dauw
+{
+  // Constructor for an arena
+  Arena::Arena()
+    : current_(nullptr), remaining_(0), allocated_(0)
+  {
+  }
+
+  // Destructor for an arena
+  Arena::~Arena()
+  {
+    // Call the destructors of the objects in reverse order of creation
+    for (auto it = finalizers_.rbegin(); it != finalizers_.rend(); it ++)
+      it->destroy(it->object);
+
+    // Free the blocks of memory
+    for (auto block : blocks_)
+      ::operator delete(block);
+  }
+
+  // Return the total number of bytes allocated in the arena
+  size_t Arena::allocated()
+  {
+    return allocated_;
+  }
+
+  // Allocate memory with the specified size and alignment
+  void* Arena::allocate(size_t size, size_t alignment)
+  {
+    // Align the pointer to the free memory in the current block
+    auto padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+
+    // Allocate a new block if the current block is too small
+    if (current_ == nullptr || padding + size > remaining_)
+    {
+      auto block_size = std::max<size_t>(DAUW_ARENA_BLOCK_SIZE, size + alignment);
+      auto block = static_cast<uint8_t*>(::operator new(block_size));
+      blocks_.push_back(block);
+
+      current_ = block;
+      remaining_ = block_size;
+      padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+    }
+
+    // Bump the pointer to the free memory
+    auto pointer = current_ + padding;
+    current_ += padding + size;
+    remaining_ -= padding + size;
+    allocated_ += size;
+    return pointer;
+  }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <dauw/common.hpp>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+// Defines for the size of the blocks of an arena
+#define DAUW_ARENA_BLOCK_SIZE 65536
+
+
+namespace dauw
+{
+  // Class that defines an arena that owns the nodes of a compilation unit and frees them at once
+  class Arena
+  {
+    private:
+      // Structure that defines an object of which the destructor is called when the arena is freed
+      struct Finalizer
+      {
+        void* object;
+        void (*destroy)(void*);
+      };
+
+
+      // The blocks of memory of the arena
+      std::vector<uint8_t*> blocks_;
+
+      // Pointer to the free memory in the current block
+      uint8_t* current_;
+
+      // The number of free bytes in the current block
+      size_t remaining_;
+
+      // The objects of which the destructor is called when the arena is freed
+      std::vector<Finalizer> finalizers_;
+
+      // The total number of bytes allocated in the arena
+      size_t allocated_;
+
+
+      // Allocate memory with the specified size and alignment
+      void* allocate(size_t size, size_t alignment);
+
+
+    public:
+      // Constructor
+      Arena();
+      Arena(const Arena&) = delete;
+
+      // Destructor
+      ~Arena();
+
+      // Assignment
+      Arena& operator=(const Arena&) = delete;
+
+      // Return the total number of bytes allocated in the arena
+      size_t allocated();
+
+      // Create an object in the arena
+      template <typename T, typename... Args>
+      inline T* make(Args&&... args)
+      {
+        auto object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+          finalizers_.push_back(Finalizer{object, [](void* object) { static_cast<T*>(object)->~T(); }});
+        return object;
+      }
+  };
+}
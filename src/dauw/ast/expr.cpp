@@ -50,7 +50,7 @@ namespace dauw
   // Accept a visitor on the literal expression
   void ExprLiteral::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_literal(shared_from_this());
+    visitor->visit_literal(this);
   }
 
   // --------------------------------------------------------------------------
@@ -86,7 +86,7 @@ namespace dauw
   // Accept a visitor on the sequence expression
   void ExprSequence::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_sequence(shared_from_this());
+    visitor->visit_sequence(this);
   }
 
   // --------------------------------------------------------------------------
@@ -122,7 +122,7 @@ namespace dauw
   // Accept a visitor on the record expression
   void ExprRecord::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_record(shared_from_this());
+    visitor->visit_record(this);
   }
 
 
@@ -149,7 +149,7 @@ namespace dauw
   // Accept a visitor on a name expression
   void ExprName::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_name(shared_from_this());
+    visitor->visit_name(this);
   }
 
   // --------------------------------------------------------------------------
@@ -193,7 +193,7 @@ namespace dauw
   // Accept a visitor on a function expression
   void ExprFunction::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_function(shared_from_this());
+    visitor->visit_function(this);
   }
 
   // --------------------------------------------------------------------------
@@ -225,7 +225,7 @@ namespace dauw
   // Accept a visitor on a function parameter expression
   void ExprFunctionParameter::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_function_parameter(shared_from_this());
+    visitor->visit_function_parameter(this);
   }
 
   // --------------------------------------------------------------------------
@@ -251,7 +251,7 @@ namespace dauw
   // Accept a visitor on a grouped expression
   void ExprGrouped::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_grouped(shared_from_this());
+    visitor->visit_grouped(this);
   }
 
   // --------------------------------------------------------------------------
@@ -283,7 +283,7 @@ namespace dauw
   // Accept a visitor on a call expression
   void ExprCall::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_call(shared_from_this());
+    visitor->visit_call(this);
   }
 
   // --------------------------------------------------------------------------
@@ -315,7 +315,7 @@ namespace dauw
   // Accept a visitor on a get expression
   void ExprGet::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_get(shared_from_this());
+    visitor->visit_get(this);
   }
 
 
@@ -340,7 +340,7 @@ namespace dauw
   }
 
   // Return if the resolved types of the operand matches the specified type
-  bool ExprUnary::check_operand_type(Type right_type)
+  bool ExprUnary::check_operand_type(Type& right_type)
   {
     return right_->check_type(right_type);
   }
@@ -354,7 +354,7 @@ namespace dauw
   // Accept a visitor on an unary expression
   void ExprUnary::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_unary(shared_from_this());
+    visitor->visit_unary(this);
   }
 
   // --------------------------------------------------------------------------
@@ -382,7 +382,7 @@ namespace dauw
   }
 
   // Return if the resolved types of the operands match the specified types
-  bool ExprBinary::check_operand_type(Type left_type, Type right_type)
+  bool ExprBinary::check_operand_type(Type& left_type, Type& right_type)
   {
     return left_->check_type(left_type) && right_->check_type(right_type);
   }
@@ -396,7 +396,7 @@ namespace dauw
   // Accept a visitor on a binary expression
   void ExprBinary::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_binary(shared_from_this());
+    visitor->visit_binary(this);
   }
 
   // --------------------------------------------------------------------------
@@ -422,7 +422,7 @@ namespace dauw
   // Accept a visitor on an echo expression
   void ExprEcho::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_echo(shared_from_this());
+    visitor->visit_echo(this);
   }
 
   // --------------------------------------------------------------------------
@@ -466,7 +466,7 @@ namespace dauw
   // Accept a visitor on a if expression
   void ExprIf::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_if(shared_from_this());
+    visitor->visit_if(this);
   }
 
   // --------------------------------------------------------------------------
@@ -504,7 +504,7 @@ namespace dauw
   // Accept a visitor on a for expression
   void ExprFor::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_for(shared_from_this());
+    visitor->visit_for(this);
   }
 
   // --------------------------------------------------------------------------
@@ -536,7 +536,7 @@ namespace dauw
   // Accept a visitor on a while expression
   void ExprWhile::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_while(shared_from_this());
+    visitor->visit_while(this);
   }
 
   // --------------------------------------------------------------------------
@@ -568,7 +568,7 @@ namespace dauw
   // Accept a visitor on an until expression
   void ExprUntil::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_until(shared_from_this());
+    visitor->visit_until(this);
   }
 
   // --------------------------------------------------------------------------
@@ -606,7 +606,7 @@ namespace dauw
   // Accept a visitor on a block expression
   void ExprBlock::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_block(shared_from_this());
+    visitor->visit_block(this);
   }
 
   // --------------------------------------------------------------------------
@@ -650,6 +650,6 @@ namespace dauw
   // Accept a visitor on a def expression
   void ExprDef::accept(const expr_visitor_ptr& visitor)
   {
-    visitor->visit_def(shared_from_this());
+    visitor->visit_def(this);
   }
 }
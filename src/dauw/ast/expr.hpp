@@ -1,6 +1,7 @@
 #pragma once
 
 #include <dauw/common.hpp>
+#include <dauw/ast/arena.hpp>
 #include <dauw/ast/node.hpp>
 #include <dauw/ast/type_expr.hpp>
 #include <dauw/frontend/location.hpp>
@@ -34,26 +35,26 @@ namespace dauw
   class ExprDef;
 
   // Type definitions for pointers
-  using expr_visitor_ptr = std::shared_ptr<ExprVisitor>;
-  using expr_ptr = std::shared_ptr<Expr>;
-  using expr_literal_ptr = std::shared_ptr<ExprLiteral>;
-  using expr_sequence_ptr = std::shared_ptr<ExprSequence>;
-  using expr_record_ptr = std::shared_ptr<ExprRecord>;
-  using expr_name_ptr = std::shared_ptr<ExprName>;
-  using expr_function_ptr = std::shared_ptr<ExprFunction>;
-  using expr_function_parameter_ptr = std::shared_ptr<ExprFunctionParameter>;
-  using expr_grouped_ptr = std::shared_ptr<ExprGrouped>;
-  using expr_call_ptr = std::shared_ptr<ExprCall>;
-  using expr_get_ptr = std::shared_ptr<ExprGet>;
-  using expr_unary_ptr = std::shared_ptr<ExprUnary>;
-  using expr_binary_ptr = std::shared_ptr<ExprBinary>;
-  using expr_echo_ptr = std::shared_ptr<ExprEcho>;
-  using expr_if_ptr = std::shared_ptr<ExprIf>;
-  using expr_for_ptr = std::shared_ptr<ExprFor>;
-  using expr_while_ptr = std::shared_ptr<ExprWhile>;
-  using expr_until_ptr = std::shared_ptr<ExprUntil>;
-  using expr_block_ptr = std::shared_ptr<ExprBlock>;
-  using expr_def_ptr = std::shared_ptr<ExprDef>;
+  using expr_visitor_ptr = ExprVisitor*;
+  using expr_ptr = Expr*;
+  using expr_literal_ptr = ExprLiteral*;
+  using expr_sequence_ptr = ExprSequence*;
+  using expr_record_ptr = ExprRecord*;
+  using expr_name_ptr = ExprName*;
+  using expr_function_ptr = ExprFunction*;
+  using expr_function_parameter_ptr = ExprFunctionParameter*;
+  using expr_grouped_ptr = ExprGrouped*;
+  using expr_call_ptr = ExprCall*;
+  using expr_get_ptr = ExprGet*;
+  using expr_unary_ptr = ExprUnary*;
+  using expr_binary_ptr = ExprBinary*;
+  using expr_echo_ptr = ExprEcho*;
+  using expr_if_ptr = ExprIf*;
+  using expr_for_ptr = ExprFor*;
+  using expr_while_ptr = ExprWhile*;
+  using expr_until_ptr = ExprUntil*;
+  using expr_block_ptr = ExprBlock*;
+  using expr_def_ptr = ExprDef*;
 
 
   // Base class that defines an expression visitor
@@ -112,7 +113,7 @@ namespace dauw
 
 
   // Class that defines a literal expression
-  class ExprLiteral : public Expr, public std::enable_shared_from_this<ExprLiteral>
+  class ExprLiteral : public Expr
   {
     private:
       // The value of the literal expression
@@ -136,7 +137,7 @@ namespace dauw
 
 
   // Class that defines a sequence expression
-  class ExprSequence : public Expr, public std::enable_shared_from_this<ExprSequence>
+  class ExprSequence : public Expr
   {
     public:
       // Type definition for the underlying sequence container
@@ -169,11 +170,11 @@ namespace dauw
 
 
   // Class that defines a record expression
-  class ExprRecord : public Expr, public std::enable_shared_from_this<ExprRecord>
+  class ExprRecord : public Expr
   {
     public:
-      // Type definition for the underlying record container
-      using record_type = std::unordered_map<string_t, expr_ptr>;
+      // Type definition for the underlying record container, which keeps the items in source order
+      using record_type = std::vector<std::pair<string_t, expr_ptr>>;
 
 
     private:
@@ -202,7 +203,7 @@ namespace dauw
 
 
   // Class that defines a function expression
-  class ExprFunction : public Expr, public std::enable_shared_from_this<ExprFunction>
+  class ExprFunction : public Expr
   {
     public:
       // Type declaration for the parameter expression
@@ -251,7 +252,7 @@ namespace dauw
 
 
   // Class that defines a function parameter expression
-  class ExprFunctionParameter : public Expr, public std::enable_shared_from_this<ExprFunctionParameter>
+  class ExprFunctionParameter : public Expr
   {
     private:
       // The name token of the function parameter expression
@@ -278,7 +279,7 @@ namespace dauw
 
 
   // Class that defines a name expression
-  class ExprName : public Expr, public std::enable_shared_from_this<ExprName>
+  class ExprName : public Expr
   {
     private:
       // The name token of the name expression
@@ -299,7 +300,7 @@ namespace dauw
 
 
   // Class that defines a grouped expression
-  class ExprGrouped : public Expr, public std::enable_shared_from_this<ExprGrouped>
+  class ExprGrouped : public Expr
   {
     private:
       // The nested expression of the grouped expression
@@ -320,7 +321,7 @@ namespace dauw
 
 
   // Class that defines a call expression
-  class ExprCall : public Expr, public std::enable_shared_from_this<ExprCall>
+  class ExprCall : public Expr
   {
     private:
       // The callee of the call expression
@@ -350,7 +351,7 @@ namespace dauw
 
 
   // Class that defines a get expression
-  class ExprGet : public Expr, public std::enable_shared_from_this<ExprGet>
+  class ExprGet : public Expr
   {
     private:
       // The object of the get expression
@@ -377,7 +378,7 @@ namespace dauw
 
 
   // Class that defines an unary expression
-  class ExprUnary : public Expr, public std::enable_shared_from_this<ExprUnary>
+  class ExprUnary : public Expr
   {
     private:
       // The operator token of the unary expression
@@ -398,7 +399,7 @@ namespace dauw
       expr_ptr right();
 
       // Return if the resolved types of the operand matches the specified type
-      bool check_operand_type(Type right_type);
+      bool check_operand_type(Type& right_type);
 
       // Expression implementation
       virtual Location& location() override;
@@ -407,7 +408,7 @@ namespace dauw
 
 
   // Class that defines a binary expression
-  class ExprBinary : public Expr, public std::enable_shared_from_this<ExprBinary>
+  class ExprBinary : public Expr
   {
     private:
       // The operator token of the binary expression
@@ -430,7 +431,7 @@ namespace dauw
       expr_ptr right();
 
       // Return if the resolved types of the operands match the specified types
-      bool check_operand_type(Type left_type, Type right_type);
+      bool check_operand_type(Type& left_type, Type& right_type);
 
       // Expression implementation
       virtual Location& location() override;
@@ -439,7 +440,7 @@ namespace dauw
 
 
   // Class that defines an echo expression
-  class ExprEcho : public Expr, public std::enable_shared_from_this<ExprEcho>
+  class ExprEcho : public Expr
   {
     private:
       // The keyword token of the echo expression
@@ -463,7 +464,7 @@ namespace dauw
 
 
   // Class that defines an if expression
-  class ExprIf : public Expr, public std::enable_shared_from_this<ExprIf>
+  class ExprIf : public Expr
   {
     private:
       // The keyword token of the if expression
@@ -502,7 +503,7 @@ namespace dauw
 
 
   // Class that defines a for expression
-  class ExprFor : public Expr, public std::enable_shared_from_this<ExprFor>
+  class ExprFor : public Expr
   {
     private:
       // The keyword token of the for expression
@@ -538,7 +539,7 @@ namespace dauw
 
 
   // Class that defines a while expression
-  class ExprWhile : public Expr, public std::enable_shared_from_this<ExprWhile>
+  class ExprWhile : public Expr
   {
     private:
       // The keyword token of the while expression
@@ -568,7 +569,7 @@ namespace dauw
 
 
   // Class that defines an until expression
-  class ExprUntil : public Expr, public std::enable_shared_from_this<ExprUntil>
+  class ExprUntil : public Expr
   {
     private:
       // The keyword token of the until expression
@@ -598,7 +599,7 @@ namespace dauw
 
 
   // Class that defines a block expression
-  class ExprBlock : public Expr, public std::enable_shared_from_this<ExprBlock>
+  class ExprBlock : public Expr
   {
     private:
       // The expressions of the block expression
@@ -623,7 +624,7 @@ namespace dauw
 
 
   // Class that defines a def expression
-  class ExprDef : public Expr, public std::enable_shared_from_this<ExprDef>
+  class ExprDef : public Expr
   {
     private:
       // The name token of the def expression
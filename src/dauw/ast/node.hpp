@@ -10,7 +10,7 @@ namespace dauw
   class Node;
 
   // Type definitions for pointers
-  using node_ptr = std::shared_ptr<Node>;
+  using node_ptr = Node*;
 
 
   // Base class that defines a node in the abstract syntax tree
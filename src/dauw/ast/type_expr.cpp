@@ -23,7 +23,7 @@ namespace dauw
   // Accept a visitor on a name type expression
   void TypeExprName::accept(const type_expr_visitor_ptr& visitor)
   {
-    visitor->visit_type_name(shared_from_this());
+    visitor->visit_type_name(this);
   }
 
   // --------------------------------------------------------------------------
@@ -49,7 +49,7 @@ namespace dauw
   // Accept a visitor on a grouped type expression
   void TypeExprGrouped::accept(const type_expr_visitor_ptr& visitor)
   {
-    visitor->visit_type_grouped(shared_from_this());
+    visitor->visit_type_grouped(this);
   }
 
   // --------------------------------------------------------------------------
@@ -81,7 +81,7 @@ namespace dauw
   // Accept a visitor on a generic type expression
   void TypeExprGeneric::accept(const type_expr_visitor_ptr& visitor)
   {
-    visitor->visit_type_generic(shared_from_this());
+    visitor->visit_type_generic(this);
   }
 
   // --------------------------------------------------------------------------
@@ -107,7 +107,7 @@ namespace dauw
   // Accept a visitor on a maybe type expression
   void TypeExprMaybe::accept(const type_expr_visitor_ptr& visitor)
   {
-    visitor->visit_type_maybe(shared_from_this());
+    visitor->visit_type_maybe(this);
   }
 
   // --------------------------------------------------------------------------
@@ -137,7 +137,7 @@ namespace dauw
   // Accept a visitor on an intersection type expression
   void TypeExprIntersection::accept(const type_expr_visitor_ptr& visitor)
   {
-    visitor->visit_type_intersection(shared_from_this());
+    visitor->visit_type_intersection(this);
   }
 
   // --------------------------------------------------------------------------
@@ -167,6 +167,6 @@ namespace dauw
   // Accept a visitor on an union type expression
   void TypeExprUnion::accept(const type_expr_visitor_ptr& visitor)
   {
-    visitor->visit_type_union(shared_from_this());
+    visitor->visit_type_union(this);
   }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <dauw/ast/arena.hpp>
 #include <dauw/ast/node.hpp>
 #include <dauw/frontend/location.hpp>
 #include <dauw/frontend/token.hpp>
@@ -18,14 +19,14 @@ namespace dauw
   class TypeExprUnion;
 
   // Type definitions for pointers
-  using type_expr_visitor_ptr = std::shared_ptr<TypeExprVisitor>;
-  using type_expr_ptr = std::shared_ptr<TypeExpr>;
-  using type_expr_name_ptr = std::shared_ptr<TypeExprName>;
-  using type_expr_grouped_ptr = std::shared_ptr<TypeExprGrouped>;
-  using type_expr_generic_ptr = std::shared_ptr<TypeExprGeneric>;
-  using type_expr_maybe_ptr = std::shared_ptr<TypeExprMaybe>;
-  using type_expr_intersection_ptr = std::shared_ptr<TypeExprIntersection>;
-  using type_expr_union_ptr = std::shared_ptr<TypeExprUnion>;
+  using type_expr_visitor_ptr = TypeExprVisitor*;
+  using type_expr_ptr = TypeExpr*;
+  using type_expr_name_ptr = TypeExprName*;
+  using type_expr_grouped_ptr = TypeExprGrouped*;
+  using type_expr_generic_ptr = TypeExprGeneric*;
+  using type_expr_maybe_ptr = TypeExprMaybe*;
+  using type_expr_intersection_ptr = TypeExprIntersection*;
+  using type_expr_union_ptr = TypeExprUnion*;
 
 
   // Base class that defines an expression visitor
@@ -58,7 +59,7 @@ namespace dauw
 
 
   // Class that defines a name type expression
-  class TypeExprName : public TypeExpr, public std::enable_shared_from_this<TypeExprName>
+  class TypeExprName : public TypeExpr
   {
     private:
       // The name token of the name type expression
@@ -79,7 +80,7 @@ namespace dauw
 
 
   // Class that defines a grouped type expression
-  class TypeExprGrouped : public TypeExpr, public std::enable_shared_from_this<TypeExprGrouped>
+  class TypeExprGrouped : public TypeExpr
   {
     private:
       // The nested type expression of the grouped type expression
@@ -100,7 +101,7 @@ namespace dauw
 
 
   // Class that defines a generic type expression
-  class TypeExprGeneric : public TypeExpr, public std::enable_shared_from_this<TypeExprGeneric>
+  class TypeExprGeneric : public TypeExpr
   {
     private:
       // The base type of the generic type expression
@@ -130,7 +131,7 @@ namespace dauw
 
 
   // Class that defines a maybe type expression
-  class TypeExprMaybe : public TypeExpr, public std::enable_shared_from_this<TypeExprMaybe>
+  class TypeExprMaybe : public TypeExpr
   {
     private:
       // The base type of the maybe type expression
@@ -154,7 +155,7 @@ namespace dauw
 
 
   // Class that defines an intersection type expression
-  class TypeExprIntersection : public TypeExpr, public std::enable_shared_from_this<TypeExprIntersection>
+  class TypeExprIntersection : public TypeExpr
   {
     private:
       // The operator of the intersection type expression
@@ -180,7 +181,7 @@ namespace dauw
 
 
   // Class that defines an union type expression
-  class TypeExprUnion : public TypeExpr, public std::enable_shared_from_this<TypeExprUnion>
+  class TypeExprUnion : public TypeExpr
   {
     private:
       // The operator of the intersection type expression
@@ -0,0 +1,715 @@
+#include "bytecode_cache.hpp"
+
+#ifdef DAUW_SOURCE_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace dauw
+{
+  // Constructor for a bytecode cache
+  BytecodeCache::BytecodeCache(source_ptr source)
+    : source_(source), path_(cache_path_(source->file())), source_hash_(hash_(source->source()))
+  {
+  }
+
+  // Return the path of the cache file
+  std::filesystem::path& BytecodeCache::path()
+  {
+    return path_;
+  }
+
+  // Load the compiled script function from the cache, or return nullptr if there is no valid cache for the source
+  ObjFunction* BytecodeCache::load(VM* vm)
+  {
+    if (!std::filesystem::is_regular_file(path_))
+      return nullptr;
+
+    try
+    {
+#ifdef DAUW_SOURCE_MMAP
+      // Map the cache file into memory, so the bytecode is read without copying the file
+      auto descriptor = ::open(path_.c_str(), O_RDONLY);
+      if (descriptor >= 0)
+      {
+        struct stat status;
+        void* mapping = MAP_FAILED;
+        if (::fstat(descriptor, &status) == 0 && status.st_size > 0)
+          mapping = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+
+        if (mapping != MAP_FAILED)
+        {
+          ObjFunction* function = nullptr;
+          try
+          {
+            function = read_(string_view_t(static_cast<const char*>(mapping), status.st_size), vm);
+          }
+          catch (...)
+          {
+            ::munmap(mapping, status.st_size);
+            throw;
+          }
+
+          ::munmap(mapping, status.st_size);
+          return function;
+        }
+      }
+#endif
+
+      // If the file could not be mapped, then read it into a buffer instead
+      auto stream = std::ifstream(path_, std::ios::binary | std::ios::ate);
+      if (!stream)
+        return nullptr;
+
+      string_t buffer(static_cast<size_t>(stream.tellg()), '\0');
+      stream.seekg(0);
+      stream.read(buffer.data(), buffer.size());
+      return read_(buffer, vm);
+    }
+    catch (Exception& ex)
+    {
+      // A cache that can't be read is ignored, so the source is compiled again
+      return nullptr;
+    }
+    catch (std::exception& ex)
+    {
+      return nullptr;
+    }
+  }
+
+  // Store the compiled script function and the globals of the virtual machine in the cache and return if that succeeded
+  bool BytecodeCache::store(ObjFunction* function, VM* vm)
+  {
+    string_t buffer;
+
+    // Write the header that identifies the source and the compiler
+    buffer.append(DAUW_BYTECODE_CACHE_MAGIC);
+    write_u32_(buffer, DAUW_BYTECODE_CACHE_VERSION);
+    write_string_(buffer, compiler_key_());
+    write_u64_(buffer, source_hash_);
+    write_u64_(buffer, source_->source().size());
+
+    // Write the names of the globals, which are referenced by their index in the bytecode
+    auto global_names = vm->global_names();
+    write_u32_(buffer, global_names.size());
+    for (auto& name : global_names)
+      write_string_(buffer, name);
+
+    // Write the script function
+    write_function_(buffer, function);
+
+    // Write the cache to a temporary file first and move it in place, so concurrent runs never read a partially written cache
+    std::error_code error;
+    std::filesystem::create_directories(path_.parent_path(), error);
+
+    auto temp_path = path_;
+    temp_path += fmt::format(".{:08x}.tmp", std::random_device()());
+    {
+      auto stream = std::ofstream(temp_path, std::ios::binary | std::ios::trunc);
+      if (!stream)
+        return false;
+      stream.write(buffer.data(), buffer.size());
+      if (!stream)
+      {
+        stream.close();
+        std::filesystem::remove(temp_path, error);
+        return false;
+      }
+    }
+
+    std::filesystem::rename(temp_path, path_, error);
+    if (error)
+    {
+      std::filesystem::remove(temp_path, error);
+      return false;
+    }
+    return true;
+  }
+
+  // Return the key that identifies the compiler that wrote the cache
+  string_t BytecodeCache::compiler_key_()
+  {
+#ifdef DAUW_COMPILER_REGISTER_OPERANDS
+    auto register_operands = true;
+#else
+    auto register_operands = false;
+#endif
+
+    return fmt::format("{} {} {} {}", DAUW_VERSION, DAUW_GIT_COMMIT_HASH, sizeof(void*), register_operands);
+  }
+
+  // Return the path of the cache file for a source file
+  std::filesystem::path BytecodeCache::cache_path_(string_t file)
+  {
+    auto path = std::filesystem::path(file);
+
+    // Store the cache in the user cache directory if one is set, and otherwise next to the source file
+    auto cache_home = std::getenv("XDG_CACHE_HOME");
+    if (cache_home != nullptr && cache_home[0] != '\0')
+    {
+      auto name = fmt::format("{}-{:016x}{}", path.stem().string(), hash_(file), DAUW_BYTECODE_CACHE_EXTENSION);
+      return std::filesystem::path(cache_home) / "dauw" / name;
+    }
+
+    return path.replace_extension(DAUW_BYTECODE_CACHE_EXTENSION);
+  }
+
+  // Return the 64-bit FNV-1a hash of a string
+  uint64_t BytecodeCache::hash_(string_view_t string)
+  {
+    uint64_t hash = 14695981039346656037ull;
+    for (auto c : string)
+    {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  // --------------------------------------------------------------------------
+  // WRITING AND READING PRIMITIVES
+  // --------------------------------------------------------------------------
+
+  // Write an 8-bit integer to a buffer
+  void BytecodeCache::write_u8_(string_t& buffer, uint8_t value)
+  {
+    buffer.push_back(static_cast<char>(value));
+  }
+
+  // Write a 32-bit integer to a buffer in the byte order of the machine
+  void BytecodeCache::write_u32_(string_t& buffer, uint32_t value)
+  {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  // Write a 64-bit integer to a buffer in the byte order of the machine
+  void BytecodeCache::write_u64_(string_t& buffer, uint64_t value)
+  {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  // Write a string prefixed by its length to a buffer
+  void BytecodeCache::write_string_(string_t& buffer, string_view_t value)
+  {
+    write_u32_(buffer, value.size());
+    buffer.append(value);
+  }
+
+  // Read an 8-bit integer from a buffer
+  uint8_t BytecodeCache::read_u8_(const char*& p, const char* end)
+  {
+    if (end - p < 1)
+      throw BytecodeCacheException("Unexpected end of the cache file");
+
+    return static_cast<uint8_t>(*p ++);
+  }
+
+  // Read a 32-bit integer from a buffer
+  uint32_t BytecodeCache::read_u32_(const char*& p, const char* end)
+  {
+    uint32_t value;
+    if (end - p < static_cast<ptrdiff_t>(sizeof(value)))
+      throw BytecodeCacheException("Unexpected end of the cache file");
+
+    std::memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return value;
+  }
+
+  // Read a 64-bit integer from a buffer
+  uint64_t BytecodeCache::read_u64_(const char*& p, const char* end)
+  {
+    uint64_t value;
+    if (end - p < static_cast<ptrdiff_t>(sizeof(value)))
+      throw BytecodeCacheException("Unexpected end of the cache file");
+
+    std::memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return value;
+  }
+
+  // Read a string prefixed by its length from a buffer
+  string_view_t BytecodeCache::read_string_(const char*& p, const char* end)
+  {
+    auto length = read_u32_(p, end);
+    if (static_cast<size_t>(end - p) < length)
+      throw BytecodeCacheException("Unexpected end of the cache file");
+
+    auto value = string_view_t(p, length);
+    p += length;
+    return value;
+  }
+
+  // --------------------------------------------------------------------------
+  // WRITING AND READING FUNCTIONS
+  // --------------------------------------------------------------------------
+
+  // Write a function and the functions in its constants to a buffer
+  void BytecodeCache::write_function_(string_t& buffer, ObjFunction* function)
+  {
+    auto& chunk = function->chunk();
+
+    write_string_(buffer, function->name());
+    write_u32_(buffer, function->arity());
+
+    // Write the bytecode and the location of every byte
+    write_u32_(buffer, chunk.size());
+    buffer.append(reinterpret_cast<const char*>(chunk.code().data()), chunk.size());
+    for (size_t offset = 0; offset < chunk.size(); offset ++)
+    {
+      write_u32_(buffer, chunk.location(offset).line());
+      write_u32_(buffer, chunk.location(offset).col());
+    }
+
+    // Write the constants
+    write_u32_(buffer, chunk.constants().size());
+    for (auto constant : chunk.constants())
+    {
+      if (constant.is_nothing())
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::NOTHING));
+      else if (constant.is_false())
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::FALSE));
+      else if (constant.is_true())
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::TRUE));
+      else if (constant.is_int())
+      {
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::INT));
+        write_u64_(buffer, static_cast<uint64_t>(constant.as_int()));
+      }
+      else if (constant.is_float())
+      {
+        auto float_value = constant.as_float();
+        uint64_t bits;
+        std::memcpy(&bits, &float_value, sizeof(bits));
+
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::FLOAT));
+        write_u64_(buffer, bits);
+      }
+      else if (constant.is_rune())
+      {
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::RUNE));
+        write_u32_(buffer, constant.as_rune());
+      }
+      else if (constant.as_obj()->type() == Type::type_string)
+      {
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::STRING));
+        write_string_(buffer, static_cast<ObjString*>(constant.as_obj())->view());
+      }
+      else
+      {
+        write_u8_(buffer, static_cast<uint8_t>(BytecodeCacheConstant::FUNCTION));
+        write_function_(buffer, static_cast<ObjFunction*>(constant.as_obj()));
+      }
+    }
+
+    // Write the record shapes as the field names that build them from the root shape
+    write_u32_(buffer, chunk.shapes().size());
+    for (auto shape : chunk.shapes())
+    {
+      write_u32_(buffer, shape->slot_count());
+      for (auto& name : shape->names())
+        write_string_(buffer, name);
+    }
+
+    // Write the names of the field caches
+    write_u32_(buffer, chunk.field_caches().size());
+    for (auto& field_cache : chunk.field_caches())
+      write_string_(buffer, field_cache.name);
+  }
+
+  // Read a function and the functions in its constants from a buffer and allocate them in the virtual machine
+  ObjFunction* BytecodeCache::read_function_(const char*& p, const char* end, VM* vm, size_t global_count)
+  {
+    auto name = read_string_(p, end);
+    auto arity = read_u32_(p, end);
+    auto function = vm->allocate_function(string_t(name), arity);
+    auto& chunk = function->chunk();
+
+    // Read the bytecode and the location of every byte
+    auto size = read_u32_(p, end);
+    if (static_cast<size_t>(end - p) < size)
+      throw BytecodeCacheException("Unexpected end of the cache file");
+
+    auto code = reinterpret_cast<const uint8_t*>(p);
+    p += size;
+    for (size_t offset = 0; offset < size; offset ++)
+    {
+      auto line = read_u32_(p, end);
+      auto col = read_u32_(p, end);
+      chunk.write(code[offset], Location(line, col));
+    }
+
+    // Read the constants
+    auto constant_count = read_u32_(p, end);
+    for (size_t i = 0; i < constant_count; i ++)
+    {
+      switch (static_cast<BytecodeCacheConstant>(read_u8_(p, end)))
+      {
+        case BytecodeCacheConstant::NOTHING:
+          chunk.add_constant(Value::value_nothing);
+          break;
+
+        case BytecodeCacheConstant::FALSE:
+          chunk.add_constant(Value::value_false);
+          break;
+
+        case BytecodeCacheConstant::TRUE:
+          chunk.add_constant(Value::value_true);
+          break;
+
+        case BytecodeCacheConstant::INT:
+          chunk.add_constant(Value::of_int(static_cast<dauw_int_t>(read_u64_(p, end))));
+          break;
+
+        case BytecodeCacheConstant::FLOAT:
+        {
+          auto bits = read_u64_(p, end);
+          dauw_float_t float_value;
+          std::memcpy(&float_value, &bits, sizeof(float_value));
+          chunk.add_constant(Value::of_float(float_value));
+          break;
+        }
+
+        case BytecodeCacheConstant::RUNE:
+          chunk.add_constant(Value::of_rune(read_u32_(p, end)));
+          break;
+
+        case BytecodeCacheConstant::STRING:
+          chunk.add_constant(Value::of_obj(vm->allocate_string(string_t(read_string_(p, end)).c_str())));
+          break;
+
+        case BytecodeCacheConstant::FUNCTION:
+          chunk.add_constant(Value::of_obj(read_function_(p, end, vm, global_count)));
+          break;
+
+        default:
+          throw BytecodeCacheException("Invalid constant in the cache file");
+      }
+    }
+
+    // Read the record shapes and rebuild them from the root shape
+    auto shape_count = read_u32_(p, end);
+    for (size_t i = 0; i < shape_count; i ++)
+    {
+      auto shape = Shape::root();
+      auto slot_count = read_u32_(p, end);
+      for (size_t slot = 0; slot < slot_count; slot ++)
+        shape = shape->transition(string_t(read_string_(p, end)));
+      chunk.add_shape(shape);
+    }
+
+    // Read the names of the field caches
+    auto field_cache_count = read_u32_(p, end);
+    for (size_t i = 0; i < field_cache_count; i ++)
+      chunk.add_field_cache(string_t(read_string_(p, end)));
+
+    verify_function_(function, global_count);
+    return function;
+  }
+
+  // Check that the operands of the bytecode of a function are in range and that every path keeps the stack balanced
+  void BytecodeCache::verify_function_(ObjFunction* function, size_t global_count)
+  {
+    auto& chunk = function->chunk();
+    auto size = chunk.size();
+    auto code = chunk.code().data();
+
+    // The stack depth at the start of every instruction that has been reached, where the frame starts with the
+    // function itself and its arguments
+    std::vector<int> depths(size, -1);
+    std::vector<size_t> pending = {0};
+    if (size == 0)
+      throw BytecodeCacheException("Empty function in the cache file");
+    if (function->arity() + 1 > UINT8_MAX)
+      throw BytecodeCacheException("Invalid arity in the cache file");
+    depths[0] = static_cast<int>(function->arity()) + 1;
+
+    // Lambda to visit the instruction at an offset with the specified stack depth
+    auto visit = [&](size_t offset, int depth) {
+      if (offset >= size)
+        throw BytecodeCacheException("Invalid jump target in the cache file");
+      if (depths[offset] == -1)
+      {
+        depths[offset] = depth;
+        pending.push_back(offset);
+      }
+      else if (depths[offset] != depth)
+        throw BytecodeCacheException("Unbalanced stack in the cache file");
+    };
+
+    // Lambda to check that an operand of the specified size is available and return the offset of the next instruction
+    auto operands = [&](size_t offset, size_t length) {
+      if (offset + 1 + length > size)
+        throw BytecodeCacheException("Truncated instruction in the cache file");
+      return offset + 1 + length;
+    };
+
+    // Lambda to check an index against a count
+    auto check = [](size_t index, size_t count, const char* what) {
+      if (index >= count)
+        throw BytecodeCacheException(fmt::format("Invalid {} in the cache file", what));
+    };
+
+    while (!pending.empty())
+    {
+      auto offset = pending.back();
+      pending.pop_back();
+      auto depth = depths[offset];
+
+      // Determine the number of values that the instruction pops and pushes
+      int pops = 0, pushes = 0;
+      size_t next;
+      auto falls_through = true;
+      std::optional<size_t> target;
+
+      switch (static_cast<OpCode>(code[offset]))
+      {
+        case OpCode::CONSTANT:
+          next = operands(offset, 2);
+          check(chunk.read_u16(offset + 1), chunk.constants().size(), "constant");
+          pushes = 1;
+          break;
+
+        case OpCode::NOTHING:
+        case OpCode::FALSE:
+        case OpCode::TRUE:
+          next = operands(offset, 0);
+          pushes = 1;
+          break;
+
+        case OpCode::POP:
+          next = operands(offset, 0);
+          pops = 1;
+          break;
+
+        case OpCode::CLOSE_SCOPE:
+          next = operands(offset, 1);
+          pops = code[offset + 1] + 1;
+          pushes = 1;
+          break;
+
+        case OpCode::GET_LOCAL:
+          next = operands(offset, 1);
+          check(code[offset + 1], depth, "local");
+          pushes = 1;
+          break;
+
+        case OpCode::GET_GLOBAL:
+          next = operands(offset, 2);
+          check(chunk.read_u16(offset + 1), global_count, "global");
+          pushes = 1;
+          break;
+
+        case OpCode::DEFINE_GLOBAL:
+          next = operands(offset, 2);
+          check(chunk.read_u16(offset + 1), global_count, "global");
+          pops = pushes = 1;
+          break;
+
+        case OpCode::SEQUENCE:
+        case OpCode::CONCAT:
+          next = operands(offset, 2);
+          pops = chunk.read_u16(offset + 1);
+          pushes = 1;
+          break;
+
+        case OpCode::RECORD:
+          next = operands(offset, 2);
+          check(chunk.read_u16(offset + 1), chunk.shapes().size(), "shape");
+          pops = chunk.shapes()[chunk.read_u16(offset + 1)]->slot_count();
+          pushes = 1;
+          break;
+
+        case OpCode::GET_FIELD:
+          next = operands(offset, 2);
+          check(chunk.read_u16(offset + 1), chunk.field_caches().size(), "field cache");
+          pops = pushes = 1;
+          break;
+
+        case OpCode::NEGATE:
+        case OpCode::LENGTH:
+        case OpCode::STRING:
+        case OpCode::NOT:
+        case OpCode::NEGATE_INT:
+        case OpCode::NEGATE_FLOAT:
+        case OpCode::ECHO:
+          next = operands(offset, 0);
+          pops = pushes = 1;
+          break;
+
+        case OpCode::CAPTURE:
+        case OpCode::MULTIPLY:
+        case OpCode::DIVIDE:
+        case OpCode::QUOTIENT:
+        case OpCode::REMAINDER:
+        case OpCode::ADD:
+        case OpCode::SUBTRACT:
+        case OpCode::COMPARE:
+        case OpCode::LESS:
+        case OpCode::LESS_EQUAL:
+        case OpCode::GREATER:
+        case OpCode::GREATER_EQUAL:
+        case OpCode::MATCH:
+        case OpCode::NOT_MATCH:
+        case OpCode::EQUAL:
+        case OpCode::NOT_EQUAL:
+        case OpCode::IDENTICAL:
+        case OpCode::NOT_IDENTICAL:
+        case OpCode::MULTIPLY_INT:
+        case OpCode::MULTIPLY_FLOAT:
+        case OpCode::DIVIDE_INT:
+        case OpCode::DIVIDE_FLOAT:
+        case OpCode::QUOTIENT_INT:
+        case OpCode::QUOTIENT_FLOAT:
+        case OpCode::REMAINDER_INT:
+        case OpCode::REMAINDER_FLOAT:
+        case OpCode::ADD_INT:
+        case OpCode::ADD_FLOAT:
+        case OpCode::SUBTRACT_INT:
+        case OpCode::SUBTRACT_FLOAT:
+        case OpCode::LESS_INT:
+        case OpCode::LESS_FLOAT:
+        case OpCode::LESS_EQUAL_INT:
+        case OpCode::LESS_EQUAL_FLOAT:
+        case OpCode::GREATER_INT:
+        case OpCode::GREATER_FLOAT:
+        case OpCode::GREATER_EQUAL_INT:
+        case OpCode::GREATER_EQUAL_FLOAT:
+        case OpCode::EQUAL_INT:
+        case OpCode::NOT_EQUAL_INT:
+          next = operands(offset, 0);
+          pops = 2;
+          pushes = 1;
+          break;
+
+        case OpCode::ADD_INT_LL:
+        case OpCode::SUBTRACT_INT_LL:
+        case OpCode::MULTIPLY_INT_LL:
+        case OpCode::LESS_INT_LL:
+        case OpCode::LESS_EQUAL_INT_LL:
+        case OpCode::GREATER_INT_LL:
+        case OpCode::GREATER_EQUAL_INT_LL:
+        case OpCode::EQUAL_INT_LL:
+        case OpCode::NOT_EQUAL_INT_LL:
+          next = operands(offset, 2);
+          check(code[offset + 1], depth, "local");
+          check(code[offset + 2], depth, "local");
+          pushes = 1;
+          break;
+
+        case OpCode::ADD_INT_LC:
+        case OpCode::SUBTRACT_INT_LC:
+        case OpCode::MULTIPLY_INT_LC:
+        case OpCode::LESS_INT_LC:
+        case OpCode::LESS_EQUAL_INT_LC:
+        case OpCode::GREATER_INT_LC:
+        case OpCode::GREATER_EQUAL_INT_LC:
+        case OpCode::EQUAL_INT_LC:
+        case OpCode::NOT_EQUAL_INT_LC:
+          next = operands(offset, 3);
+          check(code[offset + 1], depth, "local");
+          check(chunk.read_u16(offset + 2), chunk.constants().size(), "constant");
+          if (!chunk.constants()[chunk.read_u16(offset + 2)].is_int())
+            throw BytecodeCacheException("Invalid constant in the cache file");
+          pushes = 1;
+          break;
+
+        case OpCode::JUMP:
+          next = operands(offset, 2);
+          target = next + chunk.read_u16(offset + 1);
+          falls_through = false;
+          break;
+
+        case OpCode::JUMP_IF_FALSE:
+        case OpCode::JUMP_IF_TRUE:
+          next = operands(offset, 2);
+          target = next + chunk.read_u16(offset + 1);
+          pops = pushes = 1;
+          break;
+
+        case OpCode::LOOP:
+          next = operands(offset, 2);
+          if (chunk.read_u16(offset + 1) > next)
+            throw BytecodeCacheException("Invalid jump target in the cache file");
+          target = next - chunk.read_u16(offset + 1);
+          falls_through = false;
+          break;
+
+        case OpCode::CALL:
+          next = operands(offset, 1);
+          pops = code[offset + 1] + 1;
+          pushes = 1;
+          break;
+
+        case OpCode::RETURN:
+          next = operands(offset, 0);
+          pops = 1;
+          falls_through = false;
+          break;
+
+        default:
+          throw BytecodeCacheException("Invalid operation code in the cache file");
+      }
+
+      // Check that the stack holds the popped values and stays within the space that is reserved for a frame
+      if (depth < pops)
+        throw BytecodeCacheException("Unbalanced stack in the cache file");
+      auto next_depth = depth - pops + pushes;
+      if (next_depth > UINT8_MAX)
+        throw BytecodeCacheException("Stack overflow in the cache file");
+
+      if (falls_through)
+        visit(next, next_depth);
+      if (target.has_value())
+        visit(target.value(), next_depth);
+    }
+  }
+
+  // Read a compiled script function from the contents of a cache file
+  ObjFunction* BytecodeCache::read_(string_view_t contents, VM* vm)
+  {
+    auto p = contents.data();
+    auto end = p + contents.size();
+
+    // Check if the cache was written by this compiler for the current contents of the source
+    auto magic = string_view_t(DAUW_BYTECODE_CACHE_MAGIC);
+    if (contents.substr(0, magic.size()) != magic)
+      throw BytecodeCacheException("Invalid magic in the cache file");
+    p += magic.size();
+
+    if (read_u32_(p, end) != DAUW_BYTECODE_CACHE_VERSION)
+      throw BytecodeCacheException("Unsupported version of the cache file");
+    if (read_string_(p, end) != compiler_key_())
+      throw BytecodeCacheException("The cache file was written by another compiler");
+    if (read_u64_(p, end) != source_hash_ || read_u64_(p, end) != source_->source().size())
+      throw BytecodeCacheException("The cache file was written for another source");
+
+    // Read the names of the globals and check that they can be defined in the same order, so their indexes in the
+    // bytecode stay the same
+    auto defined_names = vm->global_names();
+    auto global_count = read_u32_(p, end);
+    std::vector<string_t> global_names;
+    std::unordered_set<string_t> new_names;
+    for (size_t i = 0; i < global_count; i ++)
+    {
+      auto name = string_t(read_string_(p, end));
+      if (i < defined_names.size() ? defined_names[i] != name : vm->has_global(name) || !new_names.insert(name).second)
+        throw BytecodeCacheException("Invalid global in the cache file");
+      global_names.push_back(name);
+    }
+
+    // Read the script function
+    auto function = read_function_(p, end, vm, global_count);
+    if (p != end)
+      throw BytecodeCacheException("Unexpected data at the end of the cache file");
+
+    // Define the globals only after the whole cache file has been read, so a cache that is rejected leaves the
+    // virtual machine untouched
+    for (auto& name : global_names)
+      vm->global_index(name);
+    return function;
+  }
+}
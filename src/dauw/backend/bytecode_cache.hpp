@@ -0,0 +1,113 @@
+#pragma once
+
+#include <dauw/common.hpp>
+#include <dauw/backend/chunk.hpp>
+#include <dauw/backend/vm.hpp>
+#include <dauw/frontend/source.hpp>
+#include <dauw/internals/function_object.hpp>
+#include <dauw/internals/shape.hpp>
+#include <dauw/internals/string_object.hpp>
+#include <dauw/internals/value.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <unordered_set>
+
+
+// Defines for the format of the bytecode cache, where the version must be increased when the format or the bytecode changes
+#define DAUW_BYTECODE_CACHE_MAGIC "DAUWBC"
+#define DAUW_BYTECODE_CACHE_VERSION 6
+
+#ifndef DAUW_BYTECODE_CACHE_EXTENSION
+  #define DAUW_BYTECODE_CACHE_EXTENSION ".dwc"
+#endif
+
+
+namespace dauw
+{
+  // Enum that defines the kind of a constant in the bytecode cache
+  enum class BytecodeCacheConstant : uint8_t
+  {
+    NOTHING,
+    FALSE,
+    TRUE,
+    INT,
+    FLOAT,
+    RUNE,
+    STRING,
+    FUNCTION,
+  };
+
+
+  // Class that defines a cache of the compiled bytecode of a source file, which is keyed by the hash of the source and the version of the compiler
+  class BytecodeCache
+  {
+    private:
+      // The source of which the bytecode is cached
+      source_ptr source_;
+
+      // The path of the cache file
+      std::filesystem::path path_;
+
+      // The hash of the source string
+      uint64_t source_hash_;
+
+
+      // Return the key that identifies the compiler that wrote the cache
+      static string_t compiler_key_();
+
+      // Return the path of the cache file for a source file
+      static std::filesystem::path cache_path_(string_t file);
+
+      // Return the 64-bit FNV-1a hash of a string
+      static uint64_t hash_(string_view_t string);
+
+      // Write primitives to a buffer
+      static void write_u8_(string_t& buffer, uint8_t value);
+      static void write_u32_(string_t& buffer, uint32_t value);
+      static void write_u64_(string_t& buffer, uint64_t value);
+      static void write_string_(string_t& buffer, string_view_t value);
+
+      // Read primitives from a buffer and advance past them
+      static uint8_t read_u8_(const char*& p, const char* end);
+      static uint32_t read_u32_(const char*& p, const char* end);
+      static uint64_t read_u64_(const char*& p, const char* end);
+      static string_view_t read_string_(const char*& p, const char* end);
+
+      // Write a function and the functions in its constants to a buffer
+      void write_function_(string_t& buffer, ObjFunction* function);
+
+      // Read a function and the functions in its constants from a buffer and allocate them in the virtual machine
+      ObjFunction* read_function_(const char*& p, const char* end, VM* vm, size_t global_count);
+
+      // Check that the operands of the bytecode of a function are in range and that every path keeps the stack balanced
+      static void verify_function_(ObjFunction* function, size_t global_count);
+
+      // Read a compiled script function from the contents of a cache file
+      ObjFunction* read_(string_view_t contents, VM* vm);
+
+
+    public:
+      // Constructor
+      BytecodeCache(source_ptr source);
+
+      // Return the path of the cache file
+      std::filesystem::path& path();
+
+      // Load the compiled script function from the cache, or return nullptr if there is no valid cache for the source
+      ObjFunction* load(VM* vm);
+
+      // Store the compiled script function and the globals of the virtual machine in the cache and return if that succeeded
+      bool store(ObjFunction* function, VM* vm);
+  };
+
+
+  // Exception thrown when a cache file is malformed
+  class BytecodeCacheException : public Exception
+  {
+    public:
+      inline BytecodeCacheException(string_t message, Exception* previous) : Exception(message, previous) {}
+      inline BytecodeCacheException(string_t message) : Exception(message, nullptr) {}
+  };
+}
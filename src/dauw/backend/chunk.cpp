@@ -0,0 +1,105 @@
+#include "chunk.hpp"
+
+namespace dauw
+{
+  // Constructor for a chunk
+  Chunk::Chunk()
+  {
+  }
+
+  // Return the bytecode of the chunk
+  std::vector<uint8_t>& Chunk::code()
+  {
+    return code_;
+  }
+
+  // Return the constants of the chunk
+  std::vector<Value>& Chunk::constants()
+  {
+    return constants_;
+  }
+
+  // Return the record shapes of the chunk
+  std::vector<Shape*>& Chunk::shapes()
+  {
+    return shapes_;
+  }
+
+  // Return the field caches of the chunk
+  std::vector<ChunkFieldCache>& Chunk::field_caches()
+  {
+    return field_caches_;
+  }
+
+  // Return the size of the bytecode of the chunk
+  size_t Chunk::size()
+  {
+    return code_.size();
+  }
+
+  // Return the location in the source for the byte at the specified offset
+  Location& Chunk::location(size_t offset)
+  {
+    return locations_[offset];
+  }
+
+  // Write a byte to the chunk
+  void Chunk::write(uint8_t byte, Location location)
+  {
+    code_.push_back(byte);
+    locations_.push_back(location);
+  }
+
+  // Write an operation code to the chunk
+  void Chunk::write(OpCode op, Location location)
+  {
+    write(static_cast<uint8_t>(op), location);
+  }
+
+  // Write a 16-bit operand to the chunk
+  void Chunk::write_u16(uint16_t value, Location location)
+  {
+    write(static_cast<uint8_t>((value >> 8) & 0xff), location);
+    write(static_cast<uint8_t>(value & 0xff), location);
+  }
+
+  // Read a 16-bit operand from the chunk
+  uint16_t Chunk::read_u16(size_t offset)
+  {
+    return static_cast<uint16_t>((code_[offset] << 8) | code_[offset + 1]);
+  }
+
+  // Patch a 16-bit operand in the chunk
+  void Chunk::patch_u16(size_t offset, uint16_t value)
+  {
+    code_[offset] = static_cast<uint8_t>((value >> 8) & 0xff);
+    code_[offset + 1] = static_cast<uint8_t>(value & 0xff);
+  }
+
+  // Add a constant to the chunk and return its index
+  size_t Chunk::add_constant(Value value)
+  {
+    constants_.push_back(value);
+    return constants_.size() - 1;
+  }
+
+  // Add a record shape to the chunk and return its index
+  size_t Chunk::add_shape(Shape* shape)
+  {
+    for (size_t i = 0; i < shapes_.size(); i ++)
+    {
+      if (shapes_[i] == shape)
+        return i;
+    }
+
+    shapes_.push_back(shape);
+    return shapes_.size() - 1;
+  }
+
+  // Add an empty field cache for the field with the specified name to the chunk and return its index
+  size_t Chunk::add_field_cache(string_t name)
+  {
+    field_caches_.push_back(ChunkFieldCache{name, {}, 0});
+    return field_caches_.size() - 1;
+  }
+}
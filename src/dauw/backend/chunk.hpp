@@ -0,0 +1,331 @@
+#pragma once
+
+#include <dauw/common.hpp>
+#include <dauw/frontend/location.hpp>
+#include <dauw/internals/shape.hpp>
+#include <dauw/internals/value.hpp>
+#include <array>
+
+
+// Defines for the inline caches of the chunk
+#ifndef DAUW_CHUNK_FIELD_CACHE_SIZE
+  #define DAUW_CHUNK_FIELD_CACHE_SIZE 4
+#endif
+
+
+namespace dauw
+{
+  // Enum that defines the operation codes of the virtual machine
+  enum class OpCode : uint8_t
+  {
+    // Constants
+    CONSTANT,           // u16 index: push the constant at the index
+    NOTHING,            // push nothing
+    FALSE,              // push false
+    TRUE,               // push true
+
+    // Stack manipulation
+    POP,                // pop the top value
+    CLOSE_SCOPE,        // u8 count: pop the top value, pop count values, push the top value again
+
+    // Names
+    GET_LOCAL,          // u8 slot: push the value of the local at the slot
+    GET_GLOBAL,         // u16 index: push the value of the global at the index
+    DEFINE_GLOBAL,      // u16 index: set the global at the index to the top value
+
+    // Collections
+    SEQUENCE,           // u16 count: pop count values and push a sequence of them
+    RECORD,             // u16 index: pop the values for the slots of the shape at the index and push a record of them
+    GET_FIELD,          // u16 index: replace the top record with the value of the field of the field cache at the index
+
+    // Strings
+    CONCAT,             // u16 count: pop count strings and push their concatenation
+    CAPTURE,            // pop a pattern and a string and push a sequence of the groups captured by the first match
+
+    // Unary operators
+    NEGATE,
+    LENGTH,
+    STRING,
+    NOT,
+
+    // Binary operators
+    MULTIPLY,
+    DIVIDE,
+    QUOTIENT,
+    REMAINDER,
+    ADD,
+    SUBTRACT,
+    COMPARE,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    MATCH,
+    NOT_MATCH,
+    EQUAL,
+    NOT_EQUAL,
+    IDENTICAL,
+    NOT_IDENTICAL,
+
+    // Operators specialized for operands of which the resolved type is known, which don't check the operand types
+    NEGATE_INT,
+    NEGATE_FLOAT,
+    MULTIPLY_INT,
+    MULTIPLY_FLOAT,
+    DIVIDE_INT,
+    DIVIDE_FLOAT,
+    QUOTIENT_INT,
+    QUOTIENT_FLOAT,
+    REMAINDER_INT,
+    REMAINDER_FLOAT,
+    ADD_INT,
+    ADD_FLOAT,
+    SUBTRACT_INT,
+    SUBTRACT_FLOAT,
+    LESS_INT,
+    LESS_FLOAT,
+    LESS_EQUAL_INT,
+    LESS_EQUAL_FLOAT,
+    GREATER_INT,
+    GREATER_FLOAT,
+    GREATER_EQUAL_INT,
+    GREATER_EQUAL_FLOAT,
+    EQUAL_INT,
+    NOT_EQUAL_INT,
+
+    // Int operators that read their operands from registers instead of from the stack and push the result, where the
+    // LL variants take the u8 slots of two locals and the LC variants take the u8 slot of a local and the u16 index of a constant
+    ADD_INT_LL,
+    ADD_INT_LC,
+    SUBTRACT_INT_LL,
+    SUBTRACT_INT_LC,
+    MULTIPLY_INT_LL,
+    MULTIPLY_INT_LC,
+    LESS_INT_LL,
+    LESS_INT_LC,
+    LESS_EQUAL_INT_LL,
+    LESS_EQUAL_INT_LC,
+    GREATER_INT_LL,
+    GREATER_INT_LC,
+    GREATER_EQUAL_INT_LL,
+    GREATER_EQUAL_INT_LC,
+    EQUAL_INT_LL,
+    EQUAL_INT_LC,
+    NOT_EQUAL_INT_LL,
+    NOT_EQUAL_INT_LC,
+
+    // Control flow
+    JUMP,               // u16 offset: jump forward
+    JUMP_IF_FALSE,      // u16 offset: jump forward if the top value is falsey
+    JUMP_IF_TRUE,       // u16 offset: jump forward if the top value is truthy
+    LOOP,               // u16 offset: jump backward
+
+    // Functions
+    CALL,               // u8 count: call the value below the count arguments
+    RETURN,             // return the top value from the current function
+
+    // Builtins
+    ECHO,               // print the top value and replace it with nothing
+  };
+
+
+  // Structure that defines an entry in a field cache
+  struct ChunkFieldCacheEntry
+  {
+    // The shape of a record that has been looked up
+    Shape* shape;
+
+    // The slot of the field in the shape
+    size_t slot;
+  };
+
+
+  // Structure that defines a polymorphic inline cache for looking up a field at a get expression, which becomes
+  // megamorphic when more shapes are seen than there are entries and then falls back to looking up the field in the shape
+  struct ChunkFieldCache
+  {
+    // The name of the field
+    string_t name;
+
+    // The entries of the cache for the shapes that have been looked up, with the first shape in the first entry
+    std::array<ChunkFieldCacheEntry, DAUW_CHUNK_FIELD_CACHE_SIZE> entries;
+
+    // The number of entries that are used
+    size_t entry_count;
+  };
+
+
+  // Class that defines a chunk of bytecode
+  class Chunk
+  {
+    private:
+      // The bytecode of the chunk
+      std::vector<uint8_t> code_;
+
+      // The constants of the chunk
+      std::vector<Value> constants_;
+
+      // The record shapes of the chunk
+      std::vector<Shape*> shapes_;
+
+      // The field caches of the chunk
+      std::vector<ChunkFieldCache> field_caches_;
+
+      // The locations in the source for each byte in the chunk
+      std::vector<Location> locations_;
+
+
+    public:
+      // Constructor
+      Chunk();
+
+      // Return the bytecode of the chunk
+      std::vector<uint8_t>& code();
+
+      // Return the constants of the chunk
+      std::vector<Value>& constants();
+
+      // Return the record shapes of the chunk
+      std::vector<Shape*>& shapes();
+
+      // Return the field caches of the chunk
+      std::vector<ChunkFieldCache>& field_caches();
+
+      // Return the size of the bytecode of the chunk
+      size_t size();
+
+      // Return the location in the source for the byte at the specified offset
+      Location& location(size_t offset);
+
+      // Write a byte to the chunk
+      void write(uint8_t byte, Location location);
+      void write(OpCode op, Location location);
+
+      // Write a 16-bit operand to the chunk
+      void write_u16(uint16_t value, Location location);
+
+      // Read a 16-bit operand from the chunk
+      uint16_t read_u16(size_t offset);
+
+      // Patch a 16-bit operand in the chunk
+      void patch_u16(size_t offset, uint16_t value);
+
+      // Add a constant to the chunk and return its index
+      size_t add_constant(Value value);
+
+      // Add a record shape to the chunk and return its index
+      size_t add_shape(Shape* shape);
+
+      // Add an empty field cache for the field with the specified name to the chunk and return its index
+      size_t add_field_cache(string_t name);
+  };
+}
+
+
+namespace fmt
+{
+  using namespace dauw;
+
+  // Class that defines a formatter for an operation code
+  template <>
+  struct formatter<OpCode> : formatter<string_view_t>
+  {
+    inline string_t stringify(OpCode op)
+    {
+      switch (op)
+      {
+        case OpCode::CONSTANT: return "CONSTANT";
+        case OpCode::NOTHING: return "NOTHING";
+        case OpCode::FALSE: return "FALSE";
+        case OpCode::TRUE: return "TRUE";
+        case OpCode::POP: return "POP";
+        case OpCode::CLOSE_SCOPE: return "CLOSE_SCOPE";
+        case OpCode::GET_LOCAL: return "GET_LOCAL";
+        case OpCode::GET_GLOBAL: return "GET_GLOBAL";
+        case OpCode::DEFINE_GLOBAL: return "DEFINE_GLOBAL";
+        case OpCode::SEQUENCE: return "SEQUENCE";
+        case OpCode::RECORD: return "RECORD";
+        case OpCode::GET_FIELD: return "GET_FIELD";
+        case OpCode::CONCAT: return "CONCAT";
+        case OpCode::CAPTURE: return "CAPTURE";
+        case OpCode::NEGATE: return "NEGATE";
+        case OpCode::LENGTH: return "LENGTH";
+        case OpCode::STRING: return "STRING";
+        case OpCode::NOT: return "NOT";
+        case OpCode::MULTIPLY: return "MULTIPLY";
+        case OpCode::DIVIDE: return "DIVIDE";
+        case OpCode::QUOTIENT: return "QUOTIENT";
+        case OpCode::REMAINDER: return "REMAINDER";
+        case OpCode::ADD: return "ADD";
+        case OpCode::SUBTRACT: return "SUBTRACT";
+        case OpCode::COMPARE: return "COMPARE";
+        case OpCode::LESS: return "LESS";
+        case OpCode::LESS_EQUAL: return "LESS_EQUAL";
+        case OpCode::GREATER: return "GREATER";
+        case OpCode::GREATER_EQUAL: return "GREATER_EQUAL";
+        case OpCode::MATCH: return "MATCH";
+        case OpCode::NOT_MATCH: return "NOT_MATCH";
+        case OpCode::EQUAL: return "EQUAL";
+        case OpCode::NOT_EQUAL: return "NOT_EQUAL";
+        case OpCode::IDENTICAL: return "IDENTICAL";
+        case OpCode::NOT_IDENTICAL: return "NOT_IDENTICAL";
+        case OpCode::NEGATE_INT: return "NEGATE_INT";
+        case OpCode::NEGATE_FLOAT: return "NEGATE_FLOAT";
+        case OpCode::MULTIPLY_INT: return "MULTIPLY_INT";
+        case OpCode::MULTIPLY_FLOAT: return "MULTIPLY_FLOAT";
+        case OpCode::DIVIDE_INT: return "DIVIDE_INT";
+        case OpCode::DIVIDE_FLOAT: return "DIVIDE_FLOAT";
+        case OpCode::QUOTIENT_INT: return "QUOTIENT_INT";
+        case OpCode::QUOTIENT_FLOAT: return "QUOTIENT_FLOAT";
+        case OpCode::REMAINDER_INT: return "REMAINDER_INT";
+        case OpCode::REMAINDER_FLOAT: return "REMAINDER_FLOAT";
+        case OpCode::ADD_INT: return "ADD_INT";
+        case OpCode::ADD_FLOAT: return "ADD_FLOAT";
+        case OpCode::SUBTRACT_INT: return "SUBTRACT_INT";
+        case OpCode::SUBTRACT_FLOAT: return "SUBTRACT_FLOAT";
+        case OpCode::LESS_INT: return "LESS_INT";
+        case OpCode::LESS_FLOAT: return "LESS_FLOAT";
+        case OpCode::LESS_EQUAL_INT: return "LESS_EQUAL_INT";
+        case OpCode::LESS_EQUAL_FLOAT: return "LESS_EQUAL_FLOAT";
+        case OpCode::GREATER_INT: return "GREATER_INT";
+        case OpCode::GREATER_FLOAT: return "GREATER_FLOAT";
+        case OpCode::GREATER_EQUAL_INT: return "GREATER_EQUAL_INT";
+        case OpCode::GREATER_EQUAL_FLOAT: return "GREATER_EQUAL_FLOAT";
+        case OpCode::EQUAL_INT: return "EQUAL_INT";
+        case OpCode::NOT_EQUAL_INT: return "NOT_EQUAL_INT";
+        case OpCode::ADD_INT_LL: return "ADD_INT_LL";
+        case OpCode::ADD_INT_LC: return "ADD_INT_LC";
+        case OpCode::SUBTRACT_INT_LL: return "SUBTRACT_INT_LL";
+        case OpCode::SUBTRACT_INT_LC: return "SUBTRACT_INT_LC";
+        case OpCode::MULTIPLY_INT_LL: return "MULTIPLY_INT_LL";
+        case OpCode::MULTIPLY_INT_LC: return "MULTIPLY_INT_LC";
+        case OpCode::LESS_INT_LL: return "LESS_INT_LL";
+        case OpCode::LESS_INT_LC: return "LESS_INT_LC";
+        case OpCode::LESS_EQUAL_INT_LL: return "LESS_EQUAL_INT_LL";
+        case OpCode::LESS_EQUAL_INT_LC: return "LESS_EQUAL_INT_LC";
+        case OpCode::GREATER_INT_LL: return "GREATER_INT_LL";
+        case OpCode::GREATER_INT_LC: return "GREATER_INT_LC";
+        case OpCode::GREATER_EQUAL_INT_LL: return "GREATER_EQUAL_INT_LL";
+        case OpCode::GREATER_EQUAL_INT_LC: return "GREATER_EQUAL_INT_LC";
+        case OpCode::EQUAL_INT_LL: return "EQUAL_INT_LL";
+        case OpCode::EQUAL_INT_LC: return "EQUAL_INT_LC";
+        case OpCode::NOT_EQUAL_INT_LL: return "NOT_EQUAL_INT_LL";
+        case OpCode::NOT_EQUAL_INT_LC: return "NOT_EQUAL_INT_LC";
+        case OpCode::JUMP: return "JUMP";
+        case OpCode::JUMP_IF_FALSE: return "JUMP_IF_FALSE";
+        case OpCode::JUMP_IF_TRUE: return "JUMP_IF_TRUE";
+        case OpCode::LOOP: return "LOOP";
+        case OpCode::CALL: return "CALL";
+        case OpCode::RETURN: return "RETURN";
+        case OpCode::ECHO: return "ECHO";
+        default: return "<undefined>";
+      }
+    }
+
+    template <typename FormatContext>
+    auto format(OpCode op, FormatContext& ctx)
+    {
+      return formatter<string_view_t>::format(stringify(op), ctx);
+    }
+  };
+}
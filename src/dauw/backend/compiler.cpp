@@ -0,0 +1,894 @@
+#include "compiler.hpp"
+
+namespace dauw
+{
+  // Constructor for the compiler
+  Compiler::Compiler(Reporter* reporter, VM* vm)
+    : ReporterAware(reporter), vm_(vm), statement_(nullptr)
+  {
+  }
+
+  // Compile an expression to a script function
+  ObjFunction* Compiler::compile(const expr_ptr& expr)
+  {
+    // Create the script function, of which slot 0 contains the function itself
+    auto function = vm_->allocate_function("<script>", 0);
+    functions_.push_back(CompilerFunction{function, {CompilerLocal{"", 0, 0}}, 0, 1});
+
+    // Compile the expression and return its value
+    compile_expr(expr);
+    emit(OpCode::RETURN, expr->location());
+
+    functions_.pop_back();
+    return function;
+  }
+
+  // Return the state of the function that is currently compiled
+  CompilerFunction& Compiler::current()
+  {
+    return functions_.back();
+  }
+
+  // Return the chunk of the function that is currently compiled
+  Chunk& Compiler::current_chunk()
+  {
+    return functions_.back().function->chunk();
+  }
+
+  // Compile an expression
+  void Compiler::compile_expr(const expr_ptr& expr)
+  {
+    // Emit the computed value of the expression if it has been folded into a constant
+    if (expr->has_computed_value())
+    {
+      emit_value(expr->computed_value(), expr->location());
+      return;
+    }
+
+    // Accept this visitor on the expression
+    expr->accept(this);
+  }
+
+  // Compile a function expression with the specified name
+  void Compiler::compile_function(const expr_function_ptr& expr, string_t name, bool bind_name)
+  {
+    auto parameters = expr->parameters();
+    if (parameters.size() > UINT8_MAX)
+    {
+      report<CompilerError>(expr->location(), "A function can't have more than 255 parameters");
+      emit(OpCode::NOTHING, expr->location());
+      return;
+    }
+
+    // Create the function, of which slot 0 contains the function itself and the next slots contain the parameters
+    // Slot 0 is bound to the name of the function if requested, so a local function can call itself
+    auto function = vm_->allocate_function(name, parameters.size());
+    functions_.push_back(CompilerFunction{function, {CompilerLocal{bind_name ? name : "", 0, 0}}, 0, 1});
+    for (auto parameter : parameters)
+    {
+      current().locals.push_back(CompilerLocal{parameter->name(), 0, static_cast<uint8_t>(current().stack_size)});
+      current().stack_size ++;
+    }
+
+    // Compile the body of the function and return its value
+    compile_expr(expr->body());
+    emit(OpCode::RETURN, expr->location());
+    functions_.pop_back();
+
+    // Emit the function as a constant in the enclosing function
+    emit_constant(Value::of_obj(function), expr->location());
+  }
+
+  // --------------------------------------------------------------------------
+  // EMIT FUNCTIONS
+  // --------------------------------------------------------------------------
+
+  // Collect the operands of a chain of string concatenations in evaluation order
+  void Compiler::collect_concat_operands(const expr_ptr& expr, std::vector<expr_ptr>& operands)
+  {
+    auto binary = dynamic_cast<ExprBinary*>(expr);
+    if (binary != nullptr && binary->op() == TokenKind::OPERATOR_ADD && binary->check_type(Type::type_string))
+    {
+      collect_concat_operands(binary->left(), operands);
+      collect_concat_operands(binary->right(), operands);
+    }
+    else
+      operands.push_back(expr);
+  }
+
+  // Compile an int binary expression of which the operands are locals or constants to an operation that reads its operands from registers
+  bool Compiler::compile_register_binary(const expr_binary_ptr& expr)
+  {
+    // Select the register operations for the operator
+    OpCode op_locals, op_constant;
+    switch (expr->op())
+    {
+      case TokenKind::OPERATOR_ADD:
+        op_locals = OpCode::ADD_INT_LL;
+        op_constant = OpCode::ADD_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_SUBTRACT:
+        op_locals = OpCode::SUBTRACT_INT_LL;
+        op_constant = OpCode::SUBTRACT_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_MULTIPLY:
+        op_locals = OpCode::MULTIPLY_INT_LL;
+        op_constant = OpCode::MULTIPLY_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_LESS:
+        op_locals = OpCode::LESS_INT_LL;
+        op_constant = OpCode::LESS_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_LESS_EQUAL:
+        op_locals = OpCode::LESS_EQUAL_INT_LL;
+        op_constant = OpCode::LESS_EQUAL_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_GREATER:
+        op_locals = OpCode::GREATER_INT_LL;
+        op_constant = OpCode::GREATER_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_GREATER_EQUAL:
+        op_locals = OpCode::GREATER_EQUAL_INT_LL;
+        op_constant = OpCode::GREATER_EQUAL_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_EQUAL:
+        op_locals = OpCode::EQUAL_INT_LL;
+        op_constant = OpCode::EQUAL_INT_LC;
+        break;
+
+      case TokenKind::OPERATOR_NOT_EQUAL:
+        op_locals = OpCode::NOT_EQUAL_INT_LL;
+        op_constant = OpCode::NOT_EQUAL_INT_LC;
+        break;
+
+      default:
+        return false;
+    }
+
+    if (!expr->check_operand_type(Type::type_int, Type::type_int))
+      return false;
+
+    // Check if the left operand is a local of the current function
+    auto left_name = dynamic_cast<ExprName*>(expr->left());
+    if (left_name == nullptr)
+      return false;
+
+    auto left = resolve_local(current(), left_name->name());
+    if (!left.has_value())
+      return false;
+
+    // Check if the right operand is a local of the current function or an int constant
+    auto right_name = dynamic_cast<ExprName*>(expr->right());
+    auto right_literal = dynamic_cast<ExprLiteral*>(expr->right());
+    if (right_name != nullptr)
+    {
+      auto right = resolve_local(current(), right_name->name());
+      if (!right.has_value())
+        return false;
+
+      current_chunk().write(op_locals, expr->location());
+      current_chunk().write(left->slot, expr->location());
+      current_chunk().write(right->slot, expr->location());
+    }
+    else if (right_literal != nullptr && right_literal->value().is_int())
+    {
+      // Fall back to the stack form if the constant would not fit in the operand, which reports the overflow
+      if (current_chunk().constants().size() > UINT16_MAX)
+        return false;
+
+      auto index = current_chunk().add_constant(right_literal->value());
+      current_chunk().write(op_constant, expr->location());
+      current_chunk().write(left->slot, expr->location());
+      current_chunk().write_u16(static_cast<uint16_t>(index), expr->location());
+    }
+    else
+      return false;
+
+    // The operation pushes its result on the stack
+    current().stack_size ++;
+    return true;
+  }
+
+  // Return the operation code that is specialized for the resolved type of the operand of an unary expression
+  OpCode Compiler::specialize_op(const expr_unary_ptr& expr, OpCode op, OpCode int_op, OpCode float_op)
+  {
+    if (expr->check_operand_type(Type::type_int))
+      return int_op;
+    else if (expr->check_operand_type(Type::type_float))
+      return float_op;
+    else
+      return op;
+  }
+
+  // Return the operation code that is specialized for the resolved types of the operands of a binary expression
+  OpCode Compiler::specialize_op(const expr_binary_ptr& expr, OpCode op, OpCode int_op, OpCode float_op)
+  {
+    if (expr->check_operand_type(Type::type_int, Type::type_int))
+      return int_op;
+    else if (expr->check_operand_type(Type::type_float, Type::type_float))
+      return float_op;
+    else
+      return op;
+  }
+
+  // Emit an operation code to the current chunk
+  void Compiler::emit(OpCode op, Location& location)
+  {
+    current_chunk().write(op, location);
+
+    // Keep track of the effect of the operation on the stack
+    switch (op)
+    {
+      case OpCode::NOTHING:
+      case OpCode::FALSE:
+      case OpCode::TRUE:
+        current().stack_size ++;
+        break;
+
+      case OpCode::POP:
+      case OpCode::MULTIPLY:
+      case OpCode::DIVIDE:
+      case OpCode::QUOTIENT:
+      case OpCode::REMAINDER:
+      case OpCode::ADD:
+      case OpCode::SUBTRACT:
+      case OpCode::COMPARE:
+      case OpCode::LESS:
+      case OpCode::LESS_EQUAL:
+      case OpCode::GREATER:
+      case OpCode::GREATER_EQUAL:
+      case OpCode::MATCH:
+      case OpCode::NOT_MATCH:
+      case OpCode::CAPTURE:
+      case OpCode::EQUAL:
+      case OpCode::NOT_EQUAL:
+      case OpCode::IDENTICAL:
+      case OpCode::NOT_IDENTICAL:
+      case OpCode::MULTIPLY_INT:
+      case OpCode::MULTIPLY_FLOAT:
+      case OpCode::DIVIDE_INT:
+      case OpCode::DIVIDE_FLOAT:
+      case OpCode::QUOTIENT_INT:
+      case OpCode::QUOTIENT_FLOAT:
+      case OpCode::REMAINDER_INT:
+      case OpCode::REMAINDER_FLOAT:
+      case OpCode::ADD_INT:
+      case OpCode::ADD_FLOAT:
+      case OpCode::SUBTRACT_INT:
+      case OpCode::SUBTRACT_FLOAT:
+      case OpCode::LESS_INT:
+      case OpCode::LESS_FLOAT:
+      case OpCode::LESS_EQUAL_INT:
+      case OpCode::LESS_EQUAL_FLOAT:
+      case OpCode::GREATER_INT:
+      case OpCode::GREATER_FLOAT:
+      case OpCode::GREATER_EQUAL_INT:
+      case OpCode::GREATER_EQUAL_FLOAT:
+      case OpCode::EQUAL_INT:
+      case OpCode::NOT_EQUAL_INT:
+      case OpCode::RETURN:
+        current().stack_size --;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  // Emit an operation code with an 8-bit operand to the current chunk
+  void Compiler::emit(OpCode op, uint8_t operand, Location& location)
+  {
+    current_chunk().write(op, location);
+    current_chunk().write(operand, location);
+
+    // Keep track of the effect of the operation on the stack
+    if (op == OpCode::GET_LOCAL)
+      current().stack_size ++;
+    else if (op == OpCode::CLOSE_SCOPE || op == OpCode::CALL)
+      current().stack_size -= operand;
+  }
+
+  // Emit an operation code with a 16-bit operand to the current chunk
+  void Compiler::emit_u16(OpCode op, size_t operand, Location& location)
+  {
+    if (operand > UINT16_MAX)
+    {
+      report<CompilerError>(location, fmt::format("The operand of operation {} exceeds the maximum of {}", op, UINT16_MAX));
+      operand = 0;
+    }
+
+    current_chunk().write(op, location);
+    current_chunk().write_u16(static_cast<uint16_t>(operand), location);
+
+    // Keep track of the effect of the operation on the stack
+    if (op == OpCode::CONSTANT || op == OpCode::GET_GLOBAL)
+      current().stack_size ++;
+    else if (op == OpCode::SEQUENCE || op == OpCode::CONCAT)
+      current().stack_size = current().stack_size - operand + 1;
+    else if (op == OpCode::RECORD)
+      current().stack_size = current().stack_size - current_chunk().shapes()[operand]->slot_count() + 1;
+  }
+
+  // Emit a constant to the current chunk
+  void Compiler::emit_constant(Value value, Location& location)
+  {
+    emit_u16(OpCode::CONSTANT, current_chunk().add_constant(value), location);
+  }
+
+  // Emit a value that is known at compile time to the current chunk
+  void Compiler::emit_value(Value value, Location& location)
+  {
+    if (value.is_nothing())
+      emit(OpCode::NOTHING, location);
+    else if (value.is_false())
+      emit(OpCode::FALSE, location);
+    else if (value.is_true())
+      emit(OpCode::TRUE, location);
+    else if (value.is_obj() && value.as_obj()->type() == Type::type_string)
+      emit_constant(Value::of_obj(vm_->allocate_string(static_cast<ObjString*>(value.as_obj())->c_str())), location);
+    else
+      emit_constant(value, location);
+  }
+
+  // Emit a forward jump and return the offset of its operand
+  size_t Compiler::emit_jump(OpCode op, Location& location)
+  {
+    emit_u16(op, UINT16_MAX, location);
+    return current_chunk().size() - 2;
+  }
+
+  // Patch a forward jump to jump to the current offset
+  void Compiler::patch_jump(size_t offset, Location& location)
+  {
+    auto jump = current_chunk().size() - offset - 2;
+    if (jump > UINT16_MAX)
+      report<CompilerError>(location, "Too much code to jump over");
+
+    current_chunk().patch_u16(offset, static_cast<uint16_t>(jump));
+  }
+
+  // Emit a backward jump to the specified offset
+  void Compiler::emit_loop(size_t offset, Location& location)
+  {
+    auto jump = current_chunk().size() - offset + 3;
+    if (jump > UINT16_MAX)
+      report<CompilerError>(location, "Too much code to loop over");
+
+    emit_u16(OpCode::LOOP, jump, location);
+  }
+
+  // --------------------------------------------------------------------------
+  // SCOPE FUNCTIONS
+  // --------------------------------------------------------------------------
+
+  // Begin a scope
+  void Compiler::begin_scope()
+  {
+    current().scope_depth ++;
+  }
+
+  // End a scope
+  void Compiler::end_scope(Location& location)
+  {
+    auto& function = current();
+    function.scope_depth --;
+
+    // Discard the locals of the scope, but keep the value of the scope on top of the stack
+    uint8_t count = 0;
+    while (!function.locals.empty() && function.locals.back().depth > function.scope_depth)
+    {
+      function.locals.pop_back();
+      count ++;
+    }
+
+    if (count > 0)
+      emit(OpCode::CLOSE_SCOPE, count, location);
+  }
+
+  // Return if names are currently defined as globals
+  bool Compiler::is_global_scope()
+  {
+    // Names that are defined in the outermost block of the script are globals
+    return functions_.size() == 1 && current().scope_depth <= 1;
+  }
+
+  // Declare a local for the value on top of the stack
+  void Compiler::declare_local(string_t name, Location& location)
+  {
+    auto slot = current().stack_size - 1;
+    if (slot > UINT8_MAX)
+    {
+      report<CompilerError>(location, "Too many local names in function");
+      return;
+    }
+
+    current().locals.push_back(CompilerLocal{name, current().scope_depth, static_cast<uint8_t>(slot)});
+  }
+
+  // Return the local with the specified name in the specified function
+  std::optional<CompilerLocal> Compiler::resolve_local(CompilerFunction& function, string_t name)
+  {
+    for (auto it = function.locals.rbegin(); it != function.locals.rend(); it ++)
+    {
+      if (it->name == name)
+        return std::make_optional(*it);
+    }
+    return std::nullopt;
+  }
+
+  // --------------------------------------------------------------------------
+  // EXPRESSION VISITOR IMPLEMENTATION
+  // --------------------------------------------------------------------------
+
+  // Visit a literal expression
+  void Compiler::visit_literal(const expr_literal_ptr& expr)
+  {
+    emit_value(expr->value(), expr->location());
+  }
+
+  // Visit a sequence expression
+  void Compiler::visit_sequence(const expr_sequence_ptr& expr)
+  {
+    // Compile the items of the sequence expression and collect them in a sequence
+    for (auto item_expr : *expr)
+      compile_expr(item_expr);
+    emit_u16(OpCode::SEQUENCE, expr->items().size(), expr->location());
+  }
+
+  // Visit a record expression
+  void Compiler::visit_record(const expr_record_ptr& expr)
+  {
+    // Compile the items of the record expression in source order and find the shape of the record
+    auto shape = Shape::root();
+    for (auto item_expr : *expr)
+    {
+      compile_expr(std::get<1>(item_expr));
+      shape = shape->transition(std::get<0>(item_expr));
+    }
+
+    // Collect the items in a record with the shape
+    emit_u16(OpCode::RECORD, current_chunk().add_shape(shape), expr->location());
+  }
+
+  // Visit a name expression
+  void Compiler::visit_name(const expr_name_ptr& expr)
+  {
+    // Check for a local in the current function
+    auto local = resolve_local(current(), expr->name());
+    if (local.has_value())
+    {
+      emit(OpCode::GET_LOCAL, local->slot, expr->location());
+      return;
+    }
+
+    // Check for a local in an enclosing function
+    for (auto it = functions_.rbegin() + 1; it != functions_.rend(); it ++)
+    {
+      if (resolve_local(*it, expr->name()).has_value())
+      {
+        // TODO: Implement closures
+        report<UnimplementedError>(expr->location(), fmt::format("TODO: Implement capturing the local name '{}' in a function", expr->name()));
+        emit(OpCode::NOTHING, expr->location());
+        return;
+      }
+    }
+
+    // Otherwise the name must be a global that has been defined
+    if (!vm_->has_global(expr->name()))
+    {
+      report<CompilerError>(expr->location(), fmt::format("Undefined name '{}'", expr->name()));
+      emit(OpCode::NOTHING, expr->location());
+      return;
+    }
+
+    emit_u16(OpCode::GET_GLOBAL, vm_->global_index(expr->name()), expr->location());
+  }
+
+  // Visit a function expression
+  void Compiler::visit_function(const expr_function_ptr& expr)
+  {
+    compile_function(expr, "<lambda>");
+  }
+
+  // Visit a function parameter expression
+  void Compiler::visit_function_parameter(const expr_function_parameter_ptr& /*expr*/)
+  {
+    // Function parameters are declared when compiling the function expression
+  }
+
+  // Visit a grouped expression
+  void Compiler::visit_grouped(const expr_grouped_ptr& expr)
+  {
+    compile_expr(expr->expr());
+  }
+
+  // Visit a call expression
+  void Compiler::visit_call(const expr_call_ptr& expr)
+  {
+    auto arguments = expr->arguments()->items();
+    if (arguments.size() > UINT8_MAX)
+    {
+      report<CompilerError>(expr->location(), "A call can't have more than 255 arguments");
+      emit(OpCode::NOTHING, expr->location());
+      return;
+    }
+
+    // Compile the callee and the arguments of the call expression
+    compile_expr(expr->callee());
+    for (auto argument : arguments)
+      compile_expr(argument);
+
+    // Call the callee
+    emit(OpCode::CALL, static_cast<uint8_t>(arguments.size()), expr->location());
+  }
+
+  // Visit a get expression
+  void Compiler::visit_get(const expr_get_ptr& expr)
+  {
+    // Compile the object of the get expression and look up the field using a new field cache
+    compile_expr(expr->object());
+    emit_u16(OpCode::GET_FIELD, current_chunk().add_field_cache(expr->name()), expr->location());
+  }
+
+  // Visit an unary expression
+  void Compiler::visit_unary(const expr_unary_ptr& expr)
+  {
+    // Compile the operand of the unary expression
+    compile_expr(expr->right());
+
+    // Compile the operator
+    switch (expr->op())
+    {
+      case TokenKind::OPERATOR_SUBTRACT:
+        emit(specialize_op(expr, OpCode::NEGATE, OpCode::NEGATE_INT, OpCode::NEGATE_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_LENGTH:
+        emit(OpCode::LENGTH, expr->location());
+        break;
+
+      case TokenKind::OPERATOR_STRING:
+        emit(OpCode::STRING, expr->location());
+        break;
+
+      case TokenKind::OPERATOR_LOGIC_NOT:
+        emit(OpCode::NOT, expr->location());
+        break;
+
+      // TODO: Unknown unary operator
+      default:
+        report<UnimplementedError>(expr->location(), "TODO: Unknown unary operator");
+        break;
+    }
+  }
+
+  // Visit a binary expression
+  void Compiler::visit_binary(const expr_binary_ptr& expr)
+  {
+    // Check if the expression is a logic and or logic or operation, which short-circuit
+    if (expr->op() == TokenKind::OPERATOR_LOGIC_AND || expr->op() == TokenKind::OPERATOR_LOGIC_OR)
+    {
+      compile_expr(expr->left());
+      auto jump = emit_jump(expr->op() == TokenKind::OPERATOR_LOGIC_AND ? OpCode::JUMP_IF_FALSE : OpCode::JUMP_IF_TRUE, expr->location());
+      emit(OpCode::POP, expr->location());
+      compile_expr(expr->right());
+      patch_jump(jump, expr->location());
+      return;
+    }
+
+    // Check if the expression is a chain of string concatenations, which are concatenated at once instead of copying
+    // the intermediate strings for every operation
+    if (expr->op() == TokenKind::OPERATOR_ADD && expr->check_type(Type::type_string))
+    {
+      std::vector<expr_ptr> operands;
+      collect_concat_operands(expr, operands);
+      for (auto operand : operands)
+        compile_expr(operand);
+
+      emit_u16(OpCode::CONCAT, operands.size(), expr->location());
+      return;
+    }
+
+    // Check if the operands of the expression can be read from registers instead of being pushed on the stack
+#ifdef DAUW_COMPILER_REGISTER_OPERANDS
+    if (compile_register_binary(expr))
+      return;
+#endif
+
+    // Compile the operands of the binary expression
+    compile_expr(expr->left());
+    compile_expr(expr->right());
+
+    // Compile the operator
+    switch (expr->op())
+    {
+      case TokenKind::OPERATOR_MULTIPLY:
+        emit(specialize_op(expr, OpCode::MULTIPLY, OpCode::MULTIPLY_INT, OpCode::MULTIPLY_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_DIVIDE:
+        emit(specialize_op(expr, OpCode::DIVIDE, OpCode::DIVIDE_INT, OpCode::DIVIDE_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_QUOTIENT:
+        emit(specialize_op(expr, OpCode::QUOTIENT, OpCode::QUOTIENT_INT, OpCode::QUOTIENT_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_REMAINDER:
+        emit(specialize_op(expr, OpCode::REMAINDER, OpCode::REMAINDER_INT, OpCode::REMAINDER_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_ADD:
+        emit(specialize_op(expr, OpCode::ADD, OpCode::ADD_INT, OpCode::ADD_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_SUBTRACT:
+        emit(specialize_op(expr, OpCode::SUBTRACT, OpCode::SUBTRACT_INT, OpCode::SUBTRACT_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_RANGE:
+        report<UnimplementedError>(expr->location(), "TODO: Implement compiling range operation");
+        break;
+
+      case TokenKind::OPERATOR_COMPARE:
+        emit(OpCode::COMPARE, expr->location());
+        break;
+
+      case TokenKind::OPERATOR_LESS:
+        emit(specialize_op(expr, OpCode::LESS, OpCode::LESS_INT, OpCode::LESS_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_LESS_EQUAL:
+        emit(specialize_op(expr, OpCode::LESS_EQUAL, OpCode::LESS_EQUAL_INT, OpCode::LESS_EQUAL_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_GREATER:
+        emit(specialize_op(expr, OpCode::GREATER, OpCode::GREATER_INT, OpCode::GREATER_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_GREATER_EQUAL:
+        emit(specialize_op(expr, OpCode::GREATER_EQUAL, OpCode::GREATER_EQUAL_INT, OpCode::GREATER_EQUAL_FLOAT), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_MATCH:
+        emit(OpCode::MATCH, expr->location());
+        break;
+
+      case TokenKind::OPERATOR_NOT_MATCH:
+        emit(OpCode::NOT_MATCH, expr->location());
+        break;
+
+      case TokenKind::OPERATOR_CAPTURE:
+        emit(OpCode::CAPTURE, expr->location());
+        break;
+
+      case TokenKind::OPERATOR_EQUAL:
+        emit(specialize_op(expr, OpCode::EQUAL, OpCode::EQUAL_INT, OpCode::EQUAL), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_NOT_EQUAL:
+        emit(specialize_op(expr, OpCode::NOT_EQUAL, OpCode::NOT_EQUAL_INT, OpCode::NOT_EQUAL), expr->location());
+        break;
+
+      case TokenKind::OPERATOR_IDENTICAL:
+        emit(OpCode::IDENTICAL, expr->location());
+        break;
+
+      case TokenKind::OPERATOR_NOT_IDENTICAL:
+        emit(OpCode::NOT_IDENTICAL, expr->location());
+        break;
+
+      // TODO: Unknown binary operator
+      default:
+        report<UnimplementedError>(expr->location(), "TODO: Unknown binary operator");
+        break;
+    }
+  }
+
+  // Visit an echo expression
+  void Compiler::visit_echo(const expr_echo_ptr& expr)
+  {
+    // Compile the nested expression of the echo expression
+    compile_expr(expr->expr());
+
+    // Print the value
+    emit(OpCode::ECHO, expr->location());
+  }
+
+  // Visit an if expression
+  void Compiler::visit_if(const expr_if_ptr& expr)
+  {
+    // Compile only the branch that is taken if the condition has been folded into a constant
+    if (expr->condition()->has_computed_value())
+    {
+      if (!VM::is_falsey(expr->condition()->computed_value()))
+        compile_expr(expr->true_branch());
+      else if (expr->has_false_branch())
+        compile_expr(expr->false_branch());
+      else
+        emit(OpCode::NOTHING, expr->location());
+      return;
+    }
+
+    // Compile the condition of the if expression
+    compile_expr(expr->condition());
+    auto false_jump = emit_jump(OpCode::JUMP_IF_FALSE, expr->location());
+
+    // Compile the true branch of the if expression
+    emit(OpCode::POP, expr->location());
+    compile_expr(expr->true_branch());
+    auto end_jump = emit_jump(OpCode::JUMP, expr->location());
+
+    // Compile the false branch of the if expression, or nothing if there is none
+    patch_jump(false_jump, expr->location());
+    emit(OpCode::POP, expr->location());
+    if (expr->has_false_branch())
+      compile_expr(expr->false_branch());
+    else
+      emit(OpCode::NOTHING, expr->location());
+
+    patch_jump(end_jump, expr->location());
+  }
+
+  // Visit a for expression
+  void Compiler::visit_for(const expr_for_ptr& expr)
+  {
+    // TODO: Implement compiling for expression
+    report<UnimplementedError>(expr->location(), "TODO: Implement compiling for expression");
+    emit(OpCode::NOTHING, expr->location());
+  }
+
+  // Visit a while expression
+  void Compiler::visit_while(const expr_while_ptr& expr)
+  {
+    // Compile the condition of the while expression
+    auto loop_start = current_chunk().size();
+    compile_expr(expr->condition());
+    auto exit_jump = emit_jump(OpCode::JUMP_IF_FALSE, expr->location());
+
+    // Compile the body of the while expression and discard its value
+    emit(OpCode::POP, expr->location());
+    compile_expr(expr->body());
+    emit(OpCode::POP, expr->location());
+    emit_loop(loop_start, expr->location());
+
+    // Discard the condition, which is still on the stack when exiting the loop, and return nothing
+    patch_jump(exit_jump, expr->location());
+    current().stack_size ++;
+    emit(OpCode::POP, expr->location());
+    emit(OpCode::NOTHING, expr->location());
+  }
+
+  // Visit an until expression
+  void Compiler::visit_until(const expr_until_ptr& expr)
+  {
+    // Compile the condition of the until expression
+    auto loop_start = current_chunk().size();
+    compile_expr(expr->condition());
+    auto exit_jump = emit_jump(OpCode::JUMP_IF_TRUE, expr->location());
+
+    // Compile the body of the until expression and discard its value
+    emit(OpCode::POP, expr->location());
+    compile_expr(expr->body());
+    emit(OpCode::POP, expr->location());
+    emit_loop(loop_start, expr->location());
+
+    // Discard the condition, which is still on the stack when exiting the loop, and return nothing
+    patch_jump(exit_jump, expr->location());
+    current().stack_size ++;
+    emit(OpCode::POP, expr->location());
+    emit(OpCode::NOTHING, expr->location());
+  }
+
+  // Visit a block expression
+  void Compiler::visit_block(const expr_block_ptr& expr)
+  {
+    auto exprs = expr->exprs();
+    if (exprs.empty())
+    {
+      emit(OpCode::NOTHING, expr->location());
+      return;
+    }
+
+    begin_scope();
+
+    // Compile the expressions of the block expression and discard the values of all but the last expression
+    auto enclosing_statement = statement_;
+    for (auto it = exprs.begin(); it != exprs.end(); it ++)
+    {
+      statement_ = *it;
+      compile_expr(*it);
+      if (it + 1 != exprs.end())
+        emit(OpCode::POP, (*it)->location());
+    }
+    statement_ = enclosing_statement;
+
+    end_scope(exprs.back()->location());
+  }
+
+  // Visit a def expression
+  void Compiler::visit_def(const expr_def_ptr& expr)
+  {
+    // A name can only be defined as a statement of a block, so a global is defined on every path that reaches the code
+    // after it and a local keeps its slot on the stack until the block ends
+    if (statement_ != expr)
+    {
+      report<CompilerError>(expr->location(), "A name can only be defined as a statement in a block");
+      emit(OpCode::NOTHING, expr->location());
+      return;
+    }
+
+    // Check if the def expression defines a global
+    if (is_global_scope())
+    {
+      // Reserve the global before compiling the value, so a function can call itself
+      auto index = vm_->global_index(expr->name());
+
+      auto function = dynamic_cast<ExprFunction*>(expr->value());
+      if (function != nullptr)
+        compile_function(function, expr->name());
+      else
+        compile_expr(expr->value());
+
+      emit_u16(OpCode::DEFINE_GLOBAL, index, expr->location());
+      return;
+    }
+
+    // Compile the value, which becomes the slot of the local, and push a copy as the value of the def expression
+    auto function = dynamic_cast<ExprFunction*>(expr->value());
+    if (function != nullptr)
+      compile_function(function, expr->name(), true);
+    else
+      compile_expr(expr->value());
+
+    declare_local(expr->name(), expr->location());
+    emit(OpCode::GET_LOCAL, current().locals.back().slot, expr->location());
+  }
+
+  // --------------------------------------------------------------------------
+  // TYPE EXPRESSION VISITOR IMPLEMENTATION
+  // --------------------------------------------------------------------------
+
+  // Visit a name type expression
+  void Compiler::visit_type_name(const type_expr_name_ptr& /*expr*/)
+  {
+    // Type expressions are resolved before compiling and don't emit code
+  }
+
+  // Visit a generic type expression
+  void Compiler::visit_type_generic(const type_expr_generic_ptr& /*expr*/)
+  {
+    // Type expressions are resolved before compiling and don't emit code
+  }
+
+  // Visit a grouped type expression
+  void Compiler::visit_type_grouped(const type_expr_grouped_ptr& /*expr*/)
+  {
+    // Type expressions are resolved before compiling and don't emit code
+  }
+
+  // Visit a maybe type expression
+  void Compiler::visit_type_maybe(const type_expr_maybe_ptr& /*expr*/)
+  {
+    // Type expressions are resolved before compiling and don't emit code
+  }
+
+  // Visit an intersection type expression
+  void Compiler::visit_type_intersection(const type_expr_intersection_ptr& /*expr*/)
+  {
+    // Type expressions are resolved before compiling and don't emit code
+  }
+
+  // Visit an union type expression
+  void Compiler::visit_type_union(const type_expr_union_ptr& /*expr*/)
+  {
+    // Type expressions are resolved before compiling and don't emit code
+  }
+}
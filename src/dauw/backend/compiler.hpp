@@ -0,0 +1,153 @@
+#pragma once
+
+#include <dauw/common.hpp>
+#include <dauw/errors.hpp>
+#include <dauw/ast/expr.hpp>
+#include <dauw/ast/type_expr.hpp>
+#include <dauw/backend/chunk.hpp>
+#include <dauw/backend/vm.hpp>
+#include <dauw/frontend/location.hpp>
+#include <dauw/internals/function_object.hpp>
+#include <dauw/internals/string_object.hpp>
+#include <dauw/internals/value.hpp>
+
+
+namespace dauw
+{
+  // Structure that defines a local name in a function that is being compiled
+  struct CompilerLocal
+  {
+    // The name of the local
+    string_t name;
+
+    // The scope depth at which the local is declared
+    int depth;
+
+    // The slot of the local in the call frame
+    uint8_t slot;
+  };
+
+
+  // Structure that defines the state of a function that is being compiled
+  struct CompilerFunction
+  {
+    // The function that is being compiled
+    ObjFunction* function;
+
+    // The locals of the function
+    std::vector<CompilerLocal> locals;
+
+    // The current scope depth of the function
+    int scope_depth;
+
+    // The number of values on the stack of the call frame at the current instruction
+    size_t stack_size;
+  };
+
+
+  // Class that defines the bytecode compiler
+  class Compiler : public ExprVisitor, public TypeExprVisitor, public ReporterAware
+  {
+    private:
+      // Reference to the virtual machine that allocates the compiled objects
+      VM* vm_;
+
+      // The stack of functions that are being compiled
+      std::vector<CompilerFunction> functions_;
+
+      // The expression that is currently compiled as a statement of a block
+      Expr* statement_;
+
+
+      // Return the state of the function that is currently compiled
+      CompilerFunction& current();
+
+      // Return the chunk of the function that is currently compiled
+      Chunk& current_chunk();
+
+      // Compile an expression
+      void compile_expr(const expr_ptr& expr);
+
+      // Compile a function expression with the specified name, which is bound to the function itself in its body if requested
+      void compile_function(const expr_function_ptr& expr, string_t name, bool bind_name = false);
+
+      // Collect the operands of a chain of string concatenations in evaluation order
+      void collect_concat_operands(const expr_ptr& expr, std::vector<expr_ptr>& operands);
+
+      // Compile an int binary expression of which the operands are locals or constants to an operation that reads its operands from registers, and return if the expression could be compiled that way
+      bool compile_register_binary(const expr_binary_ptr& expr);
+
+      // Return the operation code that is specialized for the resolved types of the operands of an expression, or the generic operation code if the types are not both int or both float
+      OpCode specialize_op(const expr_unary_ptr& expr, OpCode op, OpCode int_op, OpCode float_op);
+      OpCode specialize_op(const expr_binary_ptr& expr, OpCode op, OpCode int_op, OpCode float_op);
+
+      // Emit an operation code and optional operands to the current chunk
+      void emit(OpCode op, Location& location);
+      void emit(OpCode op, uint8_t operand, Location& location);
+      void emit_u16(OpCode op, size_t operand, Location& location);
+
+      // Emit a constant to the current chunk
+      void emit_constant(Value value, Location& location);
+
+      // Emit a value that is known at compile time to the current chunk
+      void emit_value(Value value, Location& location);
+
+      // Emit a forward jump and return the offset of its operand
+      size_t emit_jump(OpCode op, Location& location);
+
+      // Patch a forward jump to jump to the current offset
+      void patch_jump(size_t offset, Location& location);
+
+      // Emit a backward jump to the specified offset
+      void emit_loop(size_t offset, Location& location);
+
+      // Begin and end a scope
+      void begin_scope();
+      void end_scope(Location& location);
+
+      // Return if names are currently defined as globals
+      bool is_global_scope();
+
+      // Declare a local for the value on top of the stack
+      void declare_local(string_t name, Location& location);
+
+      // Return the local with the specified name in the specified function
+      std::optional<CompilerLocal> resolve_local(CompilerFunction& function, string_t name);
+
+
+    public:
+      // Constructor
+      Compiler(Reporter* reporter, VM* vm);
+
+      // Compile an expression to a script function
+      ObjFunction* compile(const expr_ptr& expr);
+
+      // Expression visitor implementation
+      virtual void visit_literal(const expr_literal_ptr& expr) override;
+      virtual void visit_sequence(const expr_sequence_ptr& expr) override;
+      virtual void visit_record(const expr_record_ptr& expr) override;
+      virtual void visit_name(const expr_name_ptr& expr) override;
+      virtual void visit_function(const expr_function_ptr& expr) override;
+      virtual void visit_function_parameter(const expr_function_parameter_ptr& expr) override;
+      virtual void visit_grouped(const expr_grouped_ptr& expr) override;
+      virtual void visit_call(const expr_call_ptr& expr) override;
+      virtual void visit_get(const expr_get_ptr& expr) override;
+      virtual void visit_unary(const expr_unary_ptr& expr) override;
+      virtual void visit_binary(const expr_binary_ptr& expr) override;
+      virtual void visit_echo(const expr_echo_ptr& expr) override;
+      virtual void visit_if(const expr_if_ptr& expr) override;
+      virtual void visit_for(const expr_for_ptr& expr) override;
+      virtual void visit_while(const expr_while_ptr& expr) override;
+      virtual void visit_until(const expr_until_ptr& expr) override;
+      virtual void visit_block(const expr_block_ptr& expr) override;
+      virtual void visit_def(const expr_def_ptr& expr) override;
+
+      // Type expression visitor implementation
+      virtual void visit_type_name(const type_expr_name_ptr& expr) override;
+      virtual void visit_type_generic(const type_expr_generic_ptr& expr) override;
+      virtual void visit_type_grouped(const type_expr_grouped_ptr& expr) override;
+      virtual void visit_type_maybe(const type_expr_maybe_ptr& expr) override;
+      virtual void visit_type_intersection(const type_expr_intersection_ptr& expr) override;
+      virtual void visit_type_union(const type_expr_union_ptr& expr) override;
+  };
+}
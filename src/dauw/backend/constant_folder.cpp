@@ -0,0 +1,417 @@
+#include "constant_folder.hpp"
+
+namespace dauw
+{
+  // Constructor for the constant folder
+  ConstantFolder::ConstantFolder()
+    : function_depth_(0)
+  {
+  }
+
+  // Fold the constant subexpressions of an expression
+  void ConstantFolder::fold(const expr_ptr& expr)
+  {
+    // Accept this visitor on the expression
+    expr->accept(this);
+  }
+
+  // Begin a scope
+  void ConstantFolder::begin_scope()
+  {
+    // Names that are defined in the outermost block of the script are globals
+    auto global = function_depth_ == 0 && scopes_.empty();
+    scopes_.push_back(ConstantFolderScope{{}, {}, function_depth_, global});
+  }
+
+  // End a scope
+  void ConstantFolder::end_scope()
+  {
+    scopes_.pop_back();
+  }
+
+  // Declare a name with an optional known value in the current scope
+  void ConstantFolder::declare(string_t name, std::optional<Value> value)
+  {
+    if (scopes_.empty())
+      return;
+
+    // A name that is defined more than once in the same block has no single known value, since a function may observe
+    // either definition depending on when it is called
+    auto& scope = scopes_.back();
+    if (scope.def_counts[name] > 1)
+      value = std::nullopt;
+
+    scope.names.insert_or_assign(name, value);
+  }
+
+  // Fold an expression that is not evaluated on every path in a new scope, and declare the names that it defines as
+  // unknown in the enclosing scope, except for the specified name of a loop variable
+  void ConstantFolder::fold_branch(const expr_ptr& expr, std::optional<string_t> variable)
+  {
+    begin_scope();
+    if (variable.has_value())
+      declare(variable.value(), std::nullopt);
+    fold(expr);
+    auto names = scopes_.back().names;
+    end_scope();
+
+    for (auto& name : names)
+    {
+      if (!variable.has_value() || name.first != variable.value())
+        declare(name.first, std::nullopt);
+    }
+  }
+
+  // Return the known value of a declared name
+  std::optional<Value> ConstantFolder::lookup(string_t name)
+  {
+    for (auto it = scopes_.rbegin(); it != scopes_.rend(); it ++)
+    {
+      auto found = it->names.find(name);
+      if (found == it->names.end())
+        continue;
+
+      // Locals of an enclosing function are not known inside a nested function, since they can't be captured
+      if (it->function_depth != function_depth_ && !it->global)
+        return std::nullopt;
+      return found->second;
+    }
+    return std::nullopt;
+  }
+
+  // Return if the computed value of an expression can be used as an operand of a folded operation
+  bool ConstantFolder::is_foldable(const expr_ptr& expr)
+  {
+    // Objects are never folded, since equal strings are only identical after they are interned by the virtual machine
+    return expr->has_computed_value() && !expr->computed_value().is_obj();
+  }
+
+  // Return the result of an unary operation on a known operand, with the same semantics as the virtual machine
+  std::optional<Value> ConstantFolder::fold_unary(TokenKind op, Value right)
+  {
+    switch (op)
+    {
+      case TokenKind::OPERATOR_SUBTRACT:
+        if (right.is_int())
+          return Value::of_int(-right.as_int());
+        else if (right.is_float())
+          return Value::of_float(-right.as_float());
+        return std::nullopt;
+
+      case TokenKind::OPERATOR_LOGIC_NOT:
+        return Value::of_bool(VM::is_falsey(right));
+
+      default:
+        return std::nullopt;
+    }
+  }
+
+  // Return the result of a binary operation on known operands, with the same semantics as the virtual machine
+  std::optional<Value> ConstantFolder::fold_binary(TokenKind op, Value left, Value right)
+  {
+    auto ints = left.is_int() && right.is_int();
+    auto floats = left.is_float() && right.is_float();
+
+    switch (op)
+    {
+      case TokenKind::OPERATOR_MULTIPLY:
+        if (ints)
+          return Value::of_int(left.as_int() * right.as_int());
+        else if (floats)
+          return Value::of_float(left.as_float() * right.as_float());
+        return std::nullopt;
+
+      case TokenKind::OPERATOR_DIVIDE:
+        if (ints)
+          return Value::of_float(static_cast<dauw_float_t>(left.as_int()) / static_cast<dauw_float_t>(right.as_int()));
+        else if (floats)
+          return Value::of_float(left.as_float() / right.as_float());
+        return std::nullopt;
+
+      case TokenKind::OPERATOR_QUOTIENT:
+        if (ints)
+          return Value::of_int(utils::floordiv(left.as_int(), right.as_int()));
+        else if (floats)
+          return Value::of_float(utils::floordiv(left.as_float(), right.as_float()));
+        return std::nullopt;
+
+      case TokenKind::OPERATOR_REMAINDER:
+        if (ints)
+          return Value::of_int(utils::floormod(left.as_int(), right.as_int()));
+        else if (floats)
+          return Value::of_float(utils::floormod(left.as_float(), right.as_float()));
+        return std::nullopt;
+
+      case TokenKind::OPERATOR_ADD:
+        if (ints)
+          return Value::of_int(left.as_int() + right.as_int());
+        else if (floats)
+          return Value::of_float(left.as_float() + right.as_float());
+        return std::nullopt;
+
+      case TokenKind::OPERATOR_SUBTRACT:
+        if (ints)
+          return Value::of_int(left.as_int() - right.as_int());
+        else if (floats)
+          return Value::of_float(left.as_float() - right.as_float());
+        return std::nullopt;
+
+      case TokenKind::OPERATOR_COMPARE:
+      case TokenKind::OPERATOR_LESS:
+      case TokenKind::OPERATOR_LESS_EQUAL:
+      case TokenKind::OPERATOR_GREATER:
+      case TokenKind::OPERATOR_GREATER_EQUAL:
+      {
+        dauw_int_t comparison;
+        if (ints)
+          comparison = utils::sign(left.as_int() - right.as_int());
+        else if (floats)
+          comparison = VM::compare_float(left.as_float(), right.as_float());
+        else
+          return std::nullopt;
+
+        if (op == TokenKind::OPERATOR_COMPARE)
+          return Value::of_int(comparison);
+        else if (op == TokenKind::OPERATOR_LESS)
+          return Value::of_bool(comparison < 0);
+        else if (op == TokenKind::OPERATOR_LESS_EQUAL)
+          return Value::of_bool(comparison <= 0);
+        else if (op == TokenKind::OPERATOR_GREATER)
+          return Value::of_bool(comparison > 0);
+        else
+          return Value::of_bool(comparison >= 0);
+      }
+
+      case TokenKind::OPERATOR_EQUAL:
+      case TokenKind::OPERATOR_IDENTICAL:
+        return Value::of_bool(left == right);
+
+      case TokenKind::OPERATOR_NOT_EQUAL:
+      case TokenKind::OPERATOR_NOT_IDENTICAL:
+        return Value::of_bool(left != right);
+
+      default:
+        return std::nullopt;
+    }
+  }
+
+  // --------------------------------------------------------------------------
+  // EXPRESSION VISITOR IMPLEMENTATION
+  // --------------------------------------------------------------------------
+
+  // Visit a literal expression
+  void ConstantFolder::visit_literal(const expr_literal_ptr& expr)
+  {
+    // The value of a literal expression is always known
+    expr->set_computed_value(expr->value());
+  }
+
+  // Visit a sequence expression
+  void ConstantFolder::visit_sequence(const expr_sequence_ptr& expr)
+  {
+    for (auto item_expr : *expr)
+      fold(item_expr);
+  }
+
+  // Visit a record expression
+  void ConstantFolder::visit_record(const expr_record_ptr& expr)
+  {
+    for (auto item_expr : *expr)
+      fold(std::get<1>(item_expr));
+  }
+
+  // Visit a name expression
+  void ConstantFolder::visit_name(const expr_name_ptr& expr)
+  {
+    // Propagate the value of a name that is defined with a known value
+    auto value = lookup(expr->name());
+    if (value.has_value())
+      expr->set_computed_value(value.value());
+  }
+
+  // Visit a function expression
+  void ConstantFolder::visit_function(const expr_function_ptr& expr)
+  {
+    // Fold the body of the function expression in a new scope with the parameters declared
+    function_depth_ ++;
+    begin_scope();
+    for (auto parameter : expr->parameters())
+      fold(parameter);
+    fold(expr->body());
+    end_scope();
+    function_depth_ --;
+  }
+
+  // Visit a function parameter expression
+  void ConstantFolder::visit_function_parameter(const expr_function_parameter_ptr& expr)
+  {
+    // The value of a parameter is only known when the function is called
+    declare(expr->name(), std::nullopt);
+  }
+
+  // Visit a grouped expression
+  void ConstantFolder::visit_grouped(const expr_grouped_ptr& expr)
+  {
+    fold(expr->expr());
+    if (expr->expr()->has_computed_value())
+      expr->set_computed_value_from(expr->expr());
+  }
+
+  // Visit a call expression
+  void ConstantFolder::visit_call(const expr_call_ptr& expr)
+  {
+    fold(expr->callee());
+    fold(expr->arguments());
+  }
+
+  // Visit a get expression
+  void ConstantFolder::visit_get(const expr_get_ptr& expr)
+  {
+    fold(expr->object());
+  }
+
+  // Visit an unary expression
+  void ConstantFolder::visit_unary(const expr_unary_ptr& expr)
+  {
+    fold(expr->right());
+    if (!is_foldable(expr->right()))
+      return;
+
+    // Fold the operation, unless it fails, so the error is reported at runtime
+    try
+    {
+      auto value = fold_unary(expr->op(), expr->right()->computed_value());
+      if (value.has_value())
+        expr->set_computed_value(value.value());
+    }
+    catch (ValueException& ex)
+    {
+    }
+  }
+
+  // Visit a binary expression
+  void ConstantFolder::visit_binary(const expr_binary_ptr& expr)
+  {
+    fold(expr->left());
+    fold(expr->right());
+    if (!is_foldable(expr->left()))
+      return;
+
+    // Fold a logic operation of which the left operand short-circuits, or of which both operands are known
+    if (expr->op() == TokenKind::OPERATOR_LOGIC_AND || expr->op() == TokenKind::OPERATOR_LOGIC_OR)
+    {
+      auto left_is_falsey = VM::is_falsey(expr->left()->computed_value());
+      if (left_is_falsey == (expr->op() == TokenKind::OPERATOR_LOGIC_AND))
+        expr->set_computed_value_from(expr->left());
+      else if (is_foldable(expr->right()))
+        expr->set_computed_value_from(expr->right());
+      return;
+    }
+
+    if (!is_foldable(expr->right()))
+      return;
+
+    // Fold the operation, unless it overflows or divides by zero, so the error is reported at runtime
+    try
+    {
+      auto value = fold_binary(expr->op(), expr->left()->computed_value(), expr->right()->computed_value());
+      if (value.has_value())
+        expr->set_computed_value(value.value());
+    }
+    catch (ValueException& ex)
+    {
+    }
+    catch (utils::ArithmeticException& ex)
+    {
+    }
+  }
+
+  // Visit an echo expression
+  void ConstantFolder::visit_echo(const expr_echo_ptr& expr)
+  {
+    fold(expr->expr());
+  }
+
+  // Visit an if expression
+  void ConstantFolder::visit_if(const expr_if_ptr& expr)
+  {
+    fold(expr->condition());
+    fold_branch(expr->true_branch());
+    if (expr->has_false_branch())
+      fold_branch(expr->false_branch());
+
+    // Fold the if expression if its condition is known and the branch that is taken is known too
+    if (!is_foldable(expr->condition()))
+      return;
+
+    if (!VM::is_falsey(expr->condition()->computed_value()))
+    {
+      if (is_foldable(expr->true_branch()))
+        expr->set_computed_value_from(expr->true_branch());
+    }
+    else if (!expr->has_false_branch())
+      expr->set_computed_value(Value::value_nothing);
+    else if (is_foldable(expr->false_branch()))
+      expr->set_computed_value_from(expr->false_branch());
+  }
+
+  // Visit a for expression
+  void ConstantFolder::visit_for(const expr_for_ptr& expr)
+  {
+    fold(expr->iterable());
+    fold_branch(expr->body(), expr->name());
+  }
+
+  // Visit a while expression
+  void ConstantFolder::visit_while(const expr_while_ptr& expr)
+  {
+    fold(expr->condition());
+    fold_branch(expr->body());
+  }
+
+  // Visit an until expression
+  void ConstantFolder::visit_until(const expr_until_ptr& expr)
+  {
+    fold(expr->condition());
+    fold_branch(expr->body());
+  }
+
+  // Visit a block expression
+  void ConstantFolder::visit_block(const expr_block_ptr& expr)
+  {
+    begin_scope();
+
+    // Count the definitions of every name in the block before folding it
+    for (auto sub_expr : *expr)
+    {
+      auto def = dynamic_cast<ExprDef*>(sub_expr);
+      if (def != nullptr)
+        scopes_.back().def_counts[def->name()] ++;
+    }
+
+    for (auto sub_expr : *expr)
+      fold(sub_expr);
+
+    end_scope();
+  }
+
+  // Visit a def expression
+  void ConstantFolder::visit_def(const expr_def_ptr& expr)
+  {
+    // Declare a function before folding its body, so references to itself are not resolved to an enclosing name
+    auto function = dynamic_cast<ExprFunction*>(expr->value());
+    if (function != nullptr)
+    {
+      declare(expr->name(), std::nullopt);
+      fold(expr->value());
+      return;
+    }
+
+    // Declare the name with the value of the def expression if it is known
+    fold(expr->value());
+    if (expr->value()->has_computed_value())
+      declare(expr->name(), expr->value()->computed_value());
+    else
+      declare(expr->name(), std::nullopt);
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <dauw/common.hpp>
+#include <dauw/ast/expr.hpp>
+#include <dauw/backend/vm.hpp>
+#include <dauw/internals/value.hpp>
+#include <dauw/utils/math.hpp>
+
+
+namespace dauw
+{
+  // Structure that defines a scope of the constant folder
+  struct ConstantFolderScope
+  {
+    // The names that are declared in the scope mapped to their value if it is known at compile time
+    std::unordered_map<string_t, std::optional<Value>> names;
+
+    // The number of def expressions for every name that is defined in the block of the scope
+    std::unordered_map<string_t, size_t> def_counts;
+
+    // The depth of the function in which the scope is declared
+    size_t function_depth;
+
+    // Indicate if the scope contains the globals of the script
+    bool global;
+  };
+
+
+  // Class that defines a pass over the resolved expressions that sets the computed value of every expression of which
+  // the value is known at compile time, so it is compiled as a constant instead of being evaluated at runtime
+  class ConstantFolder : public ExprVisitor
+  {
+    private:
+      // The stack of scopes that map names to their values
+      std::vector<ConstantFolderScope> scopes_;
+
+      // The depth of the function that is currently folded
+      size_t function_depth_;
+
+
+      // Begin and end a scope
+      void begin_scope();
+      void end_scope();
+
+      // Declare a name with an optional known value in the current scope
+      void declare(string_t name, std::optional<Value> value);
+
+      // Fold an expression that is not evaluated on every path in a new scope and declare the names it defines as unknown
+      void fold_branch(const expr_ptr& expr, std::optional<string_t> variable = std::nullopt);
+
+      // Return the known value of a declared name, or std::nullopt if the name is not declared or its value is not known
+      std::optional<Value> lookup(string_t name);
+
+      // Return if the computed value of an expression can be used as an operand of a folded operation
+      static bool is_foldable(const expr_ptr& expr);
+
+      // Return the result of an unary or binary operation on known operands, or std::nullopt if it is evaluated at runtime
+      static std::optional<Value> fold_unary(TokenKind op, Value right);
+      static std::optional<Value> fold_binary(TokenKind op, Value left, Value right);
+
+
+    public:
+      // Constructor
+      ConstantFolder();
+
+      // Fold the constant subexpressions of an expression
+      void fold(const expr_ptr& expr);
+
+      // Visitor implementation
+      virtual void visit_literal(const expr_literal_ptr& expr) override;
+      virtual void visit_sequence(const expr_sequence_ptr& expr) override;
+      virtual void visit_record(const expr_record_ptr& expr) override;
+      virtual void visit_name(const expr_name_ptr& expr) override;
+      virtual void visit_function(const expr_function_ptr& expr) override;
+      virtual void visit_function_parameter(const expr_function_parameter_ptr& expr) override;
+      virtual void visit_grouped(const expr_grouped_ptr& expr) override;
+      virtual void visit_call(const expr_call_ptr& expr) override;
+      virtual void visit_get(const expr_get_ptr& expr) override;
+      virtual void visit_unary(const expr_unary_ptr& expr) override;
+      virtual void visit_binary(const expr_binary_ptr& expr) override;
+      virtual void visit_echo(const expr_echo_ptr& expr) override;
+      virtual void visit_if(const expr_if_ptr& expr) override;
+      virtual void visit_for(const expr_for_ptr& expr) override;
+      virtual void visit_while(const expr_while_ptr& expr) override;
+      virtual void visit_until(const expr_until_ptr& expr) override;
+      virtual void visit_block(const expr_block_ptr& expr) override;
+      virtual void visit_def(const expr_def_ptr& expr) override;
+  };
+}
@@ -11,7 +11,7 @@ namespace dauw
   // Evaluate an expression
   Value Interpreter::evaluate(const expr_ptr& expr)
   {
-    expr->accept(shared_from_this());
+    expr->accept(this);
 
     if (expr->has_computed_value())
       return expr->computed_value();
@@ -22,7 +22,7 @@ namespace dauw
   // Evaluate a type expression
   Type Interpreter::evaluate(const type_expr_ptr& expr)
   {
-    expr->accept(shared_from_this());
+    expr->accept(this);
     return expr->type();
   }
 
@@ -288,6 +288,12 @@ namespace dauw
         expr->set_computed_value(Value::of_bool(!match(expr->location(), left, right)));
         break;
 
+      // Capture operator
+      case TokenKind::OPERATOR_CAPTURE:
+        // TODO: Implement evaluating capture operator
+        report<UnimplementedError>(expr->location(), "TODO: Implement evaluating capture operator");
+        break;
+
       // Equal operator
       case TokenKind::OPERATOR_EQUAL:
         expr->set_computed_value(Value::of_bool(equals(expr->location(), left, right)));
@@ -456,8 +462,25 @@ namespace dauw
   // Return the result of checking if two values match
   dauw_bool_t Interpreter::match(Location& location, Value left, Value right)
   {
-    report<UnimplementedError>(location, "TODO: Implement match operation function");
-    return false;
+    // TODO: Better type checking
+    if (left.is_obj() && left.as_obj()->type() == Type::type_string && right.is_obj() && right.as_obj()->type() == Type::type_string)
+    {
+      try
+      {
+        auto& regex = utils::Regex::cached(static_cast<ObjString*>(right.as_obj())->c_str());
+        return regex.matches(static_cast<ObjString*>(left.as_obj())->c_str());
+      }
+      catch (utils::RegexException& ex)
+      {
+        report<RuntimeError>(location, ex.message());
+        return false;
+      }
+    }
+    else
+    {
+      report<UnimplementedError>(location, "TODO: Implement match operation function");
+      return false;
+    }
   }
 
   // Return the result of checking if two values are equal
@@ -10,6 +10,7 @@
 #include <dauw/internals/type.hpp>
 #include <dauw/internals/value.hpp>
 #include <dauw/utils/math.hpp>
+#include <dauw/utils/regex.hpp>
 
 #include <forward_list>
 #include <type_traits>
@@ -18,7 +19,7 @@
 namespace dauw
 {
   // Class that defines the interpreter
-  class Interpreter : public ExprVisitor, public TypeExprVisitor, public ReporterAware, public std::enable_shared_from_this<Interpreter>
+  class Interpreter : public ExprVisitor, public TypeExprVisitor, public ReporterAware
   {
     private:
       // Return the result of comparing two values
@@ -6,25 +6,93 @@ namespace dauw
   TypeResolver::TypeResolver(Reporter* reporter)
     : ReporterAware(reporter)
   {
+    // Add the types that can be referenced by name
+    for (auto type : {Type::type_nothing, Type::type_bool, Type::type_int, Type::type_float, Type::type_rune, Type::type_string, Type::type_sequence, Type::type_record, Type::type_function, Type::type_type})
+      types_.insert(std::make_pair(type.name(), type));
+
+    // Begin the outermost scope
+    begin_scope();
   }
 
   // Resolve the type of an expression
   void TypeResolver::resolve(const expr_ptr& expr, bool throw_if_failed)
   {
     // Accept this visitor on the expression
-    expr->accept(shared_from_this());
+    expr->accept(this);
 
     // Check if the type of the expression has been resolved
     if (throw_if_failed && !expr->has_type())
       report<TypeUnresolvedError>(expr->location(), "Could not infer the type of the expression");
   }
 
+  // Resolve the type of a type expression
+  void TypeResolver::resolve(const type_expr_ptr& expr)
+  {
+    // Accept this visitor on the type expression
+    expr->accept(this);
+  }
+
   // Resolve if a type is a subtype of another type
   void TypeResolver::resolve_subtype_of(const expr_ptr& expr, Type& type)
   {
     // TODO: Implement proper subtype check
-    if (expr->type() != type)
-      report<TypeMismatchError>(expr->location(), fmt::format("Expected a subtype of {}, but found {}", expr->type().name(), type.name()));
+    // A type without inner types, like Record or Function, accepts every type of the same kind
+    auto matches_kind = type.inner_count() == 0 && expr->type().kind() == type.kind() && expr->type().name() == type.name();
+    if (!matches_kind && expr->type() != type)
+      report<TypeMismatchError>(expr->location(), fmt::format("Expected a subtype of {}, but found {}", type.name(), expr->type().name()));
+  }
+
+  // Begin a scope
+  void TypeResolver::begin_scope()
+  {
+    scopes_.emplace_back();
+  }
+
+  // End a scope
+  void TypeResolver::end_scope()
+  {
+    scopes_.pop_back();
+  }
+
+  // Declare a name with the specified type in the current scope
+  void TypeResolver::declare(string_t name, Type type, Location& location)
+  {
+    // A name can only be redefined in the same scope with the same type, since code that is compiled against the first
+    // definition may be specialized on its type
+    auto it = scopes_.back().find(name);
+    if (it != scopes_.back().end() && it->second != type)
+    {
+      report<TypeMismatchError>(location, fmt::format("Cannot redefine '{}' of type {} as {}", name, it->second, type));
+      return;
+    }
+
+    scopes_.back().insert_or_assign(name, type);
+  }
+
+  // Return the type of a declared name, searching from the innermost scope
+  std::optional<Type> TypeResolver::lookup(string_t name)
+  {
+    for (auto it = scopes_.rbegin(); it != scopes_.rend(); it ++)
+    {
+      auto found = it->find(name);
+      if (found != it->end())
+        return std::make_optional(found->second);
+    }
+    return std::nullopt;
+  }
+
+  // Resolve the type of a function expression from its parameters and the specified return type
+  Type TypeResolver::resolve_function_type(const expr_function_ptr& expr, Type return_type)
+  {
+    // The first inner type is the return type, followed by the types of the parameters
+    std::vector<Type> inners = {return_type};
+    for (auto parameter : expr->parameters())
+    {
+      resolve(parameter->type());
+      inners.push_back(parameter->type()->has_type() ? parameter->type()->type() : Type::type_nothing);
+    }
+
+    return Type(TypeKind::FUNCTION, Type::type_function.name(), inners);
   }
 
   // --------------------------------------------------------------------------
@@ -53,37 +121,73 @@ namespace dauw
   void TypeResolver::visit_record(const expr_record_ptr& expr)
   {
     // Resolve the items of the record expression
+    std::vector<Type> field_types;
+    std::vector<string_t> field_names;
     for (auto item_expr : *expr)
+    {
       resolve(std::get<1>(item_expr));
+      if (!std::get<1>(item_expr)->has_type())
+        return;
 
-    // TODO: Implement generic resolving of record expressions
-    expr->set_type(Type::type_record);
+      field_types.push_back(std::get<1>(item_expr)->type());
+      field_names.push_back(std::get<0>(item_expr));
+    }
+
+    // The type of the record expression is a record type with the types of its fields
+    auto type = Type(TypeKind::RECORD, Type::type_record.name(), field_types, field_names);
+    expr->set_type(type);
   }
 
   // Visit a name expression
   void TypeResolver::visit_name(const expr_name_ptr& expr)
   {
-    // TODO: Implement resolving name expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving name expression");
+    // The type of the name expression is the type of the declared name
+    auto type = lookup(expr->name());
+    if (type.has_value())
+      expr->set_type(type.value());
+    else
+      report<TypeUnresolvedError>(expr->location(), fmt::format("Undefined name '{}'", expr->name()));
   }
 
   // Visit a function expression
   void TypeResolver::visit_function(const expr_function_ptr& expr)
   {
-    // Resolve the body of the function expression
+    // Resolve the body of the function expression in a new scope with the parameters declared
+    begin_scope();
+    for (auto parameter : expr->parameters())
+      resolve(parameter);
     resolve(expr->body());
+    end_scope();
 
-    // TODO: Check if the resolved type is a subtype of the defined return type
+    if (!expr->body()->has_type())
+      return;
 
-    // The type of the function declaration expression is that of its value
-    expr->set_type(Type::type_function);
+    // Check if the resolved type is a subtype of the defined return type
+    if (expr->has_return_type())
+    {
+      resolve(expr->return_type());
+      if (!expr->return_type()->has_type())
+        return;
+
+      resolve_subtype_of(expr->body(), expr->return_type()->type());
+    }
+
+    // The type of the function expression is a function type of its return and parameter types
+    auto type = resolve_function_type(expr, expr->has_return_type() ? expr->return_type()->type() : expr->body()->type());
+    expr->set_type(type);
   }
 
   // Visit a function parameter expression
   void TypeResolver::visit_function_parameter(const expr_function_parameter_ptr& expr)
   {
-    // TODO: Implement resolving function parameter expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving function parameter expression");
+    // Resolve the type of the function parameter expression
+    resolve(expr->type());
+    if (!expr->type()->has_type())
+      return;
+
+    // Declare the parameter in the current scope
+    expr->set_type(expr->type()->type());
+    declare(expr->name(), expr->type()->type(), expr->location());
   }
 
   // Visit a grouped expression
@@ -105,8 +209,36 @@ namespace dauw
     // Resolve the arguments of the call expression
     resolve(expr->arguments());
 
-    // TODO: Implement resolving call expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving call expression");
+    if (!expr->callee()->has_type())
+      return;
+
+    // Check if the callee is a function with a known signature
+    auto callee_type = expr->callee()->type();
+    if (callee_type.kind() != TypeKind::FUNCTION || callee_type.inner_count() == 0)
+    {
+      report<TypeMismatchError>(expr->location(), fmt::format("Expected a callee of type Function, but found {}", callee_type));
+      return;
+    }
+
+    // Check the number of arguments
+    auto arguments = expr->arguments()->items();
+    if (arguments.size() != callee_type.inner_count() - 1)
+    {
+      report<TypeMismatchError>(expr->location(), fmt::format("Expected {} arguments, but found {}", callee_type.inner_count() - 1, arguments.size()));
+      return;
+    }
+
+    // Check the types of the arguments
+    for (size_t i = 0; i < arguments.size(); i ++)
+    {
+      auto parameter_type = callee_type.inner(i + 1);
+      if (arguments[i]->has_type())
+        resolve_subtype_of(arguments[i], parameter_type);
+    }
+
+    // The type of the call expression is the return type of the callee
+    auto return_type = callee_type.inner(0);
+    expr->set_type(return_type);
   }
 
   // Visit a get expression
@@ -114,21 +246,32 @@ namespace dauw
   {
     // Resolve the object of the get expression
     resolve(expr->object());
+    if (!expr->object()->has_type())
+      return;
+
+    // Check if the object is a record with a field with the specified name
+    auto object_type = expr->object()->type();
+    if (object_type.kind() != TypeKind::RECORD)
+    {
+      report<TypeMismatchError>(expr->location(), fmt::format("Expected an object of type Record, but found {}", object_type));
+      return;
+    }
 
-    // TODO: Implement resolving get expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving get expression");
+    auto index = object_type.field_index(expr->name());
+    if (!index.has_value())
+    {
+      report<TypeUnresolvedError>(expr->location(), fmt::format("Undefined field '{}' in {}", expr->name(), object_type));
+      return;
+    }
+
+    // The type of the get expression is the type of the field
+    auto type = object_type.inner(index.value());
+    expr->set_type(type);
   }
 
   // Visit an unary expression
   void TypeResolver::visit_unary(const expr_unary_ptr& expr)
   {
-    // Check if the expression is a logic not operation
-    if (expr->op() == TokenKind::OPERATOR_LOGIC_NOT)
-    {
-      // TODO: Implement resolving logic not operation
-      report<UnimplementedError>(expr->location(), "TODO: Implement resolving logic not operation");
-    }
-
     // Resolve the operand of the unary expression
     resolve(expr->right());
 
@@ -151,6 +294,11 @@ namespace dauw
         expr->set_type(Type::type_string);
         break;
 
+      case TokenKind::OPERATOR_LOGIC_NOT:
+        if (expr->check_operand_type(Type::type_bool))
+          expr->set_type(Type::type_bool);
+        break;
+
       // TODO: Unknown unary operator
       default:
         report<UnimplementedError>(expr->location(), "TODO: Unknown unary operator");
@@ -161,20 +309,6 @@ namespace dauw
   // Visit a binary expression
   void TypeResolver::visit_binary(const expr_binary_ptr& expr)
   {
-    // Check if the expression is a logic and operation
-    if (expr->op() == TokenKind::OPERATOR_LOGIC_AND)
-    {
-      // TODO: Implement compiling logic and operation
-      report<UnimplementedError>(expr->location(), "TODO: Implement compiling logic and operation");
-    }
-
-    // TODO: Check if the expression is a logic or expression
-    if (expr->op() == TokenKind::OPERATOR_LOGIC_OR)
-    {
-      // TODO: Implement compiling logic and operation
-      report<UnimplementedError>(expr->location(), "TODO: Implement compiling logic or operation");
-    }
-
     // Resolve the operands of the binary expression
     resolve(expr->left());
     resolve(expr->right());
@@ -247,6 +381,16 @@ namespace dauw
         expr->set_type(Type::type_bool);
         break;
 
+      case TokenKind::OPERATOR_CAPTURE:
+        expr->set_type(Type::type_sequence);
+        break;
+
+      case TokenKind::OPERATOR_LOGIC_AND:
+      case TokenKind::OPERATOR_LOGIC_OR:
+        if (expr->check_operand_type(Type::type_bool, Type::type_bool))
+          expr->set_type(Type::type_bool);
+        break;
+
       // TODO: Unknown binary operator
       default:
         report<UnimplementedError>(expr->location(), "TODO: Unknown binary operator");
@@ -277,8 +421,11 @@ namespace dauw
     if (expr->has_false_branch())
       resolve(expr->false_branch());
 
-    // TODO: Implement resolving if expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving if expression");
+    // The type of the if expression is that of its branches if they are the same, or nothing otherwise
+    if (expr->has_false_branch() && expr->true_branch()->has_type() && expr->false_branch()->has_type() && expr->true_branch()->type() == expr->false_branch()->type())
+      expr->set_type_from(expr->true_branch());
+    else
+      expr->set_type(Type::type_nothing);
   }
 
   // Visit a for expression
@@ -303,8 +450,8 @@ namespace dauw
     // Resolve the body of the while expression
     resolve(expr->body());
 
-    // TODO: Implement resolving while expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving while expression");
+    // The type of the while expression is nothing
+    expr->set_type(Type::type_nothing);
   }
 
   // Visit an until expression
@@ -316,16 +463,18 @@ namespace dauw
     // Resolve the body of the while expression
     resolve(expr->body());
 
-    // TODO: Implement resolving until expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving until expression");
+    // The type of the until expression is nothing
+    expr->set_type(Type::type_nothing);
   }
 
   // Visit a block expression
   void TypeResolver::visit_block(const expr_block_ptr& expr)
   {
-    // Resolve the expressions of the block expression
+    // Resolve the expressions of the block expression in a new scope
+    begin_scope();
     for (auto sub_expr : *expr)
       resolve(sub_expr);
+    end_scope();
 
     // The type of the block expression is that of the last expression in the block
     if (expr->exprs().size() > 0)
@@ -335,13 +484,31 @@ namespace dauw
   // Visit a def expression
   void TypeResolver::visit_def(const expr_def_ptr& expr)
   {
+    // Declare a function with a defined return type before resolving its body, so it can call itself
+    auto function = dynamic_cast<ExprFunction*>(expr->value());
+    if (function != nullptr && function->has_return_type())
+    {
+      resolve(function->return_type());
+      if (function->return_type()->has_type())
+        declare(expr->name(), resolve_function_type(function, function->return_type()->type()), expr->location());
+    }
+
     // Resolve the value of the def expression
     resolve(expr->value());
+    if (!expr->value()->has_type())
+      return;
 
-    // TODO: Check if the resolved type is a subtype of the defined type
+    // Check if the resolved type is a subtype of the defined type
+    if (expr->has_type())
+    {
+      resolve(expr->type());
+      if (expr->type()->has_type())
+        resolve_subtype_of(expr->value(), expr->type()->type());
+    }
 
     // The type of the def expression is that of its value
     expr->set_type_from(expr->value());
+    declare(expr->name(), expr->value()->type(), expr->location());
   }
 
   // --------------------------------------------------------------------------
@@ -351,15 +518,23 @@ namespace dauw
   // Visit a name type expression
   void TypeResolver::visit_type_name(const type_expr_name_ptr& expr)
   {
-    // TODO: Implement resolving name type expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving name type expression");
+    // The type of the name type expression is the type with that name
+    auto it = types_.find(expr->name());
+    if (it != types_.end())
+      expr->set_type(it->second);
+    else
+      report<TypeUnresolvedError>(expr->location(), fmt::format("Undefined type '{}'", expr->name()));
   }
 
   // Visit a grouped type expression
   void TypeResolver::visit_type_grouped(const type_expr_grouped_ptr& expr)
   {
-    // TODO: Implement resolving grouped type expression
-    report<UnimplementedError>(expr->location(), "TODO: Implement resolving grouped type expression");
+    // Resolve the nested type expression of the grouped type expression
+    resolve(expr->expr());
+
+    // The type of the grouped type expression is that of its nested type expression
+    if (expr->expr()->has_type())
+      expr->set_type(expr->expr()->type());
   }
 
   // Visit a generic type expression
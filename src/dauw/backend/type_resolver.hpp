@@ -12,8 +12,30 @@
 namespace dauw
 {
   // Class that defines the type resolver
-  class TypeResolver : public ExprVisitor, public TypeExprVisitor, public ReporterAware, public std::enable_shared_from_this<TypeResolver>
+  class TypeResolver : public ExprVisitor, public TypeExprVisitor, public ReporterAware
   {
+    private:
+      // The types that can be referenced by name
+      std::unordered_map<string_t, Type> types_;
+
+      // The stack of scopes that map names to their types
+      std::vector<std::unordered_map<string_t, Type>> scopes_;
+
+
+      // Begin and end a scope
+      void begin_scope();
+      void end_scope();
+
+      // Declare a name with the specified type in the current scope
+      void declare(string_t name, Type type, Location& location);
+
+      // Return the type of a declared name, searching from the innermost scope
+      std::optional<Type> lookup(string_t name);
+
+      // Resolve the type of a function expression from its parameters and the specified return type
+      Type resolve_function_type(const expr_function_ptr& expr, Type return_type);
+
+
     public:
       // Constructor
       TypeResolver(Reporter* reporter);
@@ -21,6 +43,9 @@ namespace dauw
       // Resolve the type of an expression
       void resolve(const expr_ptr& expr, bool throw_if_failed = true);
 
+      // Resolve the type of a type expression
+      void resolve(const type_expr_ptr& expr);
+
       // Resolve if a type is a subtype of another type
       void resolve_subtype_of(const expr_ptr& expr, Type& type);
 
@@ -2,15 +2,59 @@
 
 namespace dauw
 {
-  // Constructor
-  VM::VM()
+  // Constructor for a call frame
+  VMFrame::VMFrame(ObjFunction* function, Value* slots)
+    : function_(function), ip_(function->chunk().code().data()), slots_(slots)
   {
+  }
 
+  // Constructor for an empty call frame
+  VMFrame::VMFrame()
+    : function_(nullptr), ip_(nullptr), slots_(nullptr)
+  {
+  }
+
+  // Return the function that is executed in the frame
+  ObjFunction* VMFrame::function()
+  {
+    return function_;
   }
 
-  // Destructor
+  // Return the instruction pointer of the frame
+  uint8_t*& VMFrame::ip()
+  {
+    return ip_;
+  }
+
+  // Return the first slot of the frame on the stack
+  Value* VMFrame::slots()
+  {
+    return slots_;
+  }
+
+  // Return the location of the instruction that is currently executed
+  Location& VMFrame::location()
+  {
+    auto& chunk = function_->chunk();
+    auto offset = static_cast<size_t>(ip_ - chunk.code().data());
+    return chunk.location(offset > 0 ? offset - 1 : 0);
+  }
+
+  // --------------------------------------------------------------------------
+
+  // Constructor for the virtual machine
+  VM::VM(Reporter* reporter)
+    : ReporterAware(reporter), bytes_allocated_(0), next_collection_(DAUW_GC_INITIAL_THRESHOLD), gc_initial_threshold_(DAUW_GC_INITIAL_THRESHOLD), gc_growth_factor_(DAUW_GC_GROWTH_FACTOR), stack_(DAUW_VM_STACK_MAX, Value::value_nothing), frames_(DAUW_VM_FRAMES_MAX), frame_count_(0), instruction_count_(0)
+  {
+    stack_top_ = stack_.data();
+  }
+
+  // Destructor for the virtual machine
   VM::~VM()
   {
+    // Clear the interned strings
+    strings_.clear();
+
     // Destroy the objects
     while (!objects_.empty())
     {
@@ -21,16 +65,50 @@ namespace dauw
     }
   }
 
-  // Collect the marked objects
+  // Collect the objects that are not reachable from the stack, the call frames or the globals
   void VM::collect()
   {
+    mark_roots();
+    trace_references();
+    strings_.remove_unmarked();
+    sweep();
+
+    // Let the heap grow relative to the surviving bytes before the next collection
+    next_collection_ = std::max(gc_initial_threshold_, static_cast<size_t>(bytes_allocated_ * gc_growth_factor_));
+  }
+
+  // Return the number of bytes that are owned by the defined objects
+  size_t VM::bytes_allocated()
+  {
+    return bytes_allocated_;
+  }
+
+  // Set the number of allocated bytes at which the first collection is triggered
+  void VM::set_gc_initial_threshold(size_t threshold)
+  {
+    gc_initial_threshold_ = threshold;
+    next_collection_ = std::max(gc_initial_threshold_, static_cast<size_t>(bytes_allocated_ * gc_growth_factor_));
+  }
+
+  // Set the factor by which the heap may grow relative to the surviving bytes before the next collection
+  void VM::set_gc_growth_factor(double factor)
+  {
+    if (factor < 1.0)
+      throw std::invalid_argument("The growth factor of the garbage collector must be at least 1.0");
 
+    gc_growth_factor_ = factor;
+    next_collection_ = std::max(gc_initial_threshold_, static_cast<size_t>(bytes_allocated_ * gc_growth_factor_));
   }
 
-  // Append an object
+  // Append an object and trigger a collection if the allocation threshold has been reached
   void VM::append_object(Obj* object)
   {
+    // Only collect while code is executed, since the objects that are allocated by the compiler are not reachable from any root yet
+    if (frame_count_ > 0 && bytes_allocated_ >= next_collection_)
+      collect();
+
     objects_.push_front(object);
+    bytes_allocated_ += object->size();
   }
 
   // Free an object
@@ -39,11 +117,1250 @@ namespace dauw
     delete object;
   }
 
-  // Allocate a string
+  // Allocate a string, or return the interned string with the same characters
   ObjString* VM::allocate_string(const char* bytes)
   {
+    auto length = std::strlen(bytes);
+    auto hash = ObjString::hash(bytes, length);
+
+    auto interned = strings_.find(bytes, length, hash);
+    if (interned != nullptr)
+      return interned;
+
     auto string = new ObjString(bytes);
-    objects_.push_front(string);
+    append_object(string);
+    strings_.insert(string);
     return string;
   }
+
+  // Allocate a slice of a string at the specified byte offset and length at code point boundaries, or return the interned string with the same characters
+  ObjString* VM::allocate_slice(ObjString* parent, size_t offset, size_t length)
+  {
+    if (offset + length > parent->byte_length())
+      throw std::out_of_range(fmt::format("{}", offset + length));
+
+    auto bytes = parent->data() + offset;
+    auto hash = ObjString::hash(bytes, length);
+
+    auto interned = strings_.find(bytes, length, hash);
+    if (interned != nullptr)
+      return interned;
+
+    // Copy slices that fit inline, and slices that would keep a disproportionately large parent alive
+    ObjString* string;
+    if (length <= DAUW_STRING_INLINE_CAPACITY || length * DAUW_STRING_SLICE_MIN_FRACTION < parent->byte_length())
+      string = new ObjString(string_t(bytes, length).c_str());
+    else
+      string = new ObjString(parent, offset, length);
+
+    append_object(string);
+    strings_.insert(string);
+    return string;
+  }
+
+  // Allocate a function
+  ObjFunction* VM::allocate_function(string_t name, size_t arity)
+  {
+    auto function = new ObjFunction(name, arity);
+    append_object(function);
+    return function;
+  }
+
+  // Allocate a sequence from an array of items
+  ObjSequence* VM::allocate_sequence(const Value* items, size_t count)
+  {
+    auto sequence = new ObjSequence(items, count);
+    append_object(sequence);
+    return sequence;
+  }
+
+  // Allocate a record with the specified shape from an array of slot values
+  ObjRecord* VM::allocate_record(Shape* shape, const Value* values)
+  {
+    auto record = new ObjRecord(shape, values);
+    append_object(record);
+    return record;
+  }
+
+  // Return the index of a global name, or define it if it doesn't exist yet
+  size_t VM::global_index(string_t name)
+  {
+    auto it = global_indexes_.find(name);
+    if (it != global_indexes_.end())
+      return it->second;
+
+    globals_.push_back(Value::value_nothing);
+    global_indexes_.insert(std::make_pair(name, globals_.size() - 1));
+    return globals_.size() - 1;
+  }
+
+  // Return if a global name has been defined
+  bool VM::has_global(string_t name)
+  {
+    return global_indexes_.count(name) > 0;
+  }
+
+  // Return the number of dispatched instructions
+  size_t VM::instruction_count()
+  {
+    return instruction_count_;
+  }
+
+  // Return the names of the globals in index order
+  std::vector<string_t> VM::global_names()
+  {
+    std::vector<string_t> names(globals_.size());
+    for (auto& global_index : global_indexes_)
+      names[global_index.second] = global_index.first;
+    return names;
+  }
+
+  // Run a compiled script function and return if it completed without errors
+  bool VM::run(ObjFunction* function)
+  {
+    // Reset the stack and call the script function
+    stack_top_ = stack_.data();
+    frame_count_ = 0;
+
+    push(Value::of_obj(function));
+    if (!call(Value::of_obj(function), 0))
+      return false;
+
+    // Execute the script function
+    Value result = Value::value_nothing;
+    auto success = execute(result);
+
+    // Reset the stack after the execution
+    stack_top_ = stack_.data();
+    frame_count_ = 0;
+    return success;
+  }
+
+  // --------------------------------------------------------------------------
+  // STACK FUNCTIONS
+  // --------------------------------------------------------------------------
+
+  // Push a value onto the stack
+  void VM::push(Value value)
+  {
+    *stack_top_ = value;
+    stack_top_ ++;
+  }
+
+  // Pop a value from the stack
+  Value VM::pop()
+  {
+    stack_top_ --;
+    return *stack_top_;
+  }
+
+  // Return a value on the stack at the specified distance from the top
+  Value& VM::peek(size_t distance)
+  {
+    return stack_top_[-1 - static_cast<ptrdiff_t>(distance)];
+  }
+
+  // --------------------------------------------------------------------------
+  // EXECUTION FUNCTIONS
+  // --------------------------------------------------------------------------
+
+  // Call a function with the specified number of arguments on the stack
+  bool VM::call(Value callee, size_t arg_count)
+  {
+    // Check if the callee is a function
+    if (!callee.is_obj() || callee.as_obj()->type() != Type::type_function)
+    {
+      runtime_error<RuntimeError>(fmt::format("A value of type {} is not callable", callee.type()));
+      return false;
+    }
+
+    auto function = static_cast<ObjFunction*>(callee.as_obj());
+
+    // Check the number of arguments
+    if (arg_count != function->arity())
+    {
+      runtime_error<RuntimeError>(fmt::format("Expected {} arguments to {}, but got {}", function->arity(), function->name(), arg_count));
+      return false;
+    }
+
+    // Check if there is room for another call frame
+    if (frame_count_ == DAUW_VM_FRAMES_MAX || (stack_top_ - stack_.data()) + 256 > DAUW_VM_STACK_MAX)
+    {
+      if (frame_count_ > 0)
+        runtime_error<StackOverflowError>("The maximum call depth has been exceeded");
+      return false;
+    }
+
+    // Push a new call frame
+    frames_[frame_count_ ++] = VMFrame(function, stack_top_ - arg_count - 1);
+    return true;
+  }
+
+  // Execute the call frames until the outermost frame returns
+  bool VM::execute(Value& result)
+  {
+    // Cache the current frame and instruction pointer
+    VMFrame* frame = &frames_[frame_count_ - 1];
+    uint8_t* ip = frame->ip();
+    Value* constants = frame->function()->chunk().constants().data();
+
+    // Macros for reading the bytecode
+    #define READ_BYTE() (*ip ++)
+    #define READ_U16() (ip += 2, static_cast<uint16_t>((ip[-2] << 8) | ip[-1]))
+    #define SAVE_FRAME() (frame->ip() = ip)
+    #define LOAD_FRAME() (frame = &frames_[frame_count_ - 1], ip = frame->ip(), constants = frame->function()->chunk().constants().data())
+    #define RUNTIME_ERROR(type, message) do { SAVE_FRAME(); runtime_error<type>(message); return false; } while (false)
+
+    // Macro for counting the dispatched instructions
+    #ifdef DAUW_VM_COUNT_INSTRUCTIONS
+      #define COUNT_INSTRUCTION() (instruction_count_ ++)
+    #else
+      #define COUNT_INSTRUCTION() ((void)0)
+    #endif
+
+    // Macros for dispatching the operations, which jump from the end of each operation directly to the next one through a table of label addresses if the compiler supports computed goto, or use a switch statement otherwise
+    #ifdef DAUW_VM_COMPUTED_GOTO
+      void* dispatch_table[256];
+      std::fill(std::begin(dispatch_table), std::end(dispatch_table), &&op_UNKNOWN);
+
+      #define LABEL(op) (dispatch_table[static_cast<uint8_t>(OpCode::op)] = &&op_##op)
+      LABEL(CONSTANT);
+      LABEL(NOTHING);
+      LABEL(FALSE);
+      LABEL(TRUE);
+      LABEL(POP);
+      LABEL(CLOSE_SCOPE);
+      LABEL(GET_LOCAL);
+      LABEL(GET_GLOBAL);
+      LABEL(DEFINE_GLOBAL);
+      LABEL(SEQUENCE);
+      LABEL(RECORD);
+      LABEL(GET_FIELD);
+      LABEL(CONCAT);
+      LABEL(CAPTURE);
+      LABEL(NEGATE);
+      LABEL(LENGTH);
+      LABEL(STRING);
+      LABEL(NOT);
+      LABEL(MULTIPLY);
+      LABEL(DIVIDE);
+      LABEL(QUOTIENT);
+      LABEL(REMAINDER);
+      LABEL(ADD);
+      LABEL(SUBTRACT);
+      LABEL(COMPARE);
+      LABEL(LESS);
+      LABEL(LESS_EQUAL);
+      LABEL(GREATER);
+      LABEL(GREATER_EQUAL);
+      LABEL(MATCH);
+      LABEL(NOT_MATCH);
+      LABEL(EQUAL);
+      LABEL(NOT_EQUAL);
+      LABEL(IDENTICAL);
+      LABEL(NOT_IDENTICAL);
+      LABEL(NEGATE_INT);
+      LABEL(NEGATE_FLOAT);
+      LABEL(MULTIPLY_INT);
+      LABEL(MULTIPLY_FLOAT);
+      LABEL(DIVIDE_INT);
+      LABEL(DIVIDE_FLOAT);
+      LABEL(QUOTIENT_INT);
+      LABEL(QUOTIENT_FLOAT);
+      LABEL(REMAINDER_INT);
+      LABEL(REMAINDER_FLOAT);
+      LABEL(ADD_INT);
+      LABEL(ADD_FLOAT);
+      LABEL(SUBTRACT_INT);
+      LABEL(SUBTRACT_FLOAT);
+      LABEL(LESS_INT);
+      LABEL(LESS_FLOAT);
+      LABEL(LESS_EQUAL_INT);
+      LABEL(LESS_EQUAL_FLOAT);
+      LABEL(GREATER_INT);
+      LABEL(GREATER_FLOAT);
+      LABEL(GREATER_EQUAL_INT);
+      LABEL(GREATER_EQUAL_FLOAT);
+      LABEL(EQUAL_INT);
+      LABEL(NOT_EQUAL_INT);
+      LABEL(ADD_INT_LL);
+      LABEL(ADD_INT_LC);
+      LABEL(SUBTRACT_INT_LL);
+      LABEL(SUBTRACT_INT_LC);
+      LABEL(MULTIPLY_INT_LL);
+      LABEL(MULTIPLY_INT_LC);
+      LABEL(LESS_INT_LL);
+      LABEL(LESS_INT_LC);
+      LABEL(LESS_EQUAL_INT_LL);
+      LABEL(LESS_EQUAL_INT_LC);
+      LABEL(GREATER_INT_LL);
+      LABEL(GREATER_INT_LC);
+      LABEL(GREATER_EQUAL_INT_LL);
+      LABEL(GREATER_EQUAL_INT_LC);
+      LABEL(EQUAL_INT_LL);
+      LABEL(EQUAL_INT_LC);
+      LABEL(NOT_EQUAL_INT_LL);
+      LABEL(NOT_EQUAL_INT_LC);
+      LABEL(JUMP);
+      LABEL(JUMP_IF_FALSE);
+      LABEL(JUMP_IF_TRUE);
+      LABEL(LOOP);
+      LABEL(CALL);
+      LABEL(RETURN);
+      LABEL(ECHO);
+      #undef LABEL
+
+      #define DISPATCH() COUNT_INSTRUCTION(); goto *dispatch_table[READ_BYTE()];
+      #define CASE(op) op_##op:
+      #define CASE_UNKNOWN() op_UNKNOWN:
+      #define NEXT() DISPATCH()
+    #else
+      #define DISPATCH() COUNT_INSTRUCTION(); switch (static_cast<OpCode>(READ_BYTE()))
+      #define CASE(op) case OpCode::op:
+      #define CASE_UNKNOWN() default:
+      #define NEXT() break
+    #endif
+
+    try
+    {
+      while (true)
+      {
+        DISPATCH()
+        {
+          // Constants
+          CASE(CONSTANT)
+            push(constants[READ_U16()]);
+            NEXT();
+
+          CASE(NOTHING)
+            push(Value::value_nothing);
+            NEXT();
+
+          CASE(FALSE)
+            push(Value::value_false);
+            NEXT();
+
+          CASE(TRUE)
+            push(Value::value_true);
+            NEXT();
+
+          // Stack manipulation
+          CASE(POP)
+            stack_top_ --;
+            NEXT();
+
+          CASE(CLOSE_SCOPE)
+          {
+            auto count = READ_BYTE();
+            auto value = pop();
+            stack_top_ -= count;
+            push(value);
+            NEXT();
+          }
+
+          // Names
+          CASE(GET_LOCAL)
+            push(frame->slots()[READ_BYTE()]);
+            NEXT();
+
+          CASE(GET_GLOBAL)
+            push(globals_[READ_U16()]);
+            NEXT();
+
+          CASE(DEFINE_GLOBAL)
+            globals_[READ_U16()] = peek();
+            NEXT();
+
+          // Collections
+          CASE(SEQUENCE)
+          {
+            // Allocate the sequence while the items are still on the stack, so they are reachable during a collection
+            auto count = READ_U16();
+            auto sequence = allocate_sequence(stack_top_ - count, count);
+            stack_top_ -= count;
+            push(Value::of_obj(sequence));
+            NEXT();
+          }
+
+          CASE(RECORD)
+          {
+            // Allocate the record while the values are still on the stack, so they are reachable during a collection
+            auto shape = frame->function()->chunk().shapes()[READ_U16()];
+            auto count = shape->slot_count();
+            auto record = allocate_record(shape, stack_top_ - count);
+            stack_top_ -= count;
+            push(Value::of_obj(record));
+            NEXT();
+          }
+
+          CASE(GET_FIELD)
+          {
+            auto& cache = frame->function()->chunk().field_caches()[READ_U16()];
+            auto& object = peek();
+            if (!object.is_obj() || object.as_obj()->type() != Type::type_record)
+              RUNTIME_ERROR(RuntimeError, fmt::format("A value of type {} has no fields", object.type()));
+
+            // Use the slot of the cache entry for the shape of the record if there is one
+            auto record = static_cast<ObjRecord*>(object.as_obj());
+            auto shape = record->shape();
+            size_t i = 0;
+            while (i < cache.entry_count && cache.entries[i].shape != shape)
+              i ++;
+
+            if (i < cache.entry_count)
+            {
+              object = record->slot(cache.entries[i].slot);
+              NEXT();
+            }
+
+            // Otherwise look up the slot of the field in the shape and add it to the cache if it isn't megamorphic yet
+            auto slot = shape->slot(cache.name);
+            if (!slot.has_value())
+              RUNTIME_ERROR(RuntimeError, fmt::format("Undefined field '{}' in record", cache.name));
+
+            if (cache.entry_count < cache.entries.size())
+              cache.entries[cache.entry_count ++] = ChunkFieldCacheEntry{shape, slot.value()};
+
+            object = record->slot(slot.value());
+            NEXT();
+          }
+
+          // Strings
+          CASE(CONCAT)
+          {
+            // Copy the strings into a buffer of their combined length while they are still on the stack
+            auto count = READ_U16();
+            auto strings = stack_top_ - count;
+
+            size_t length = 0;
+            for (size_t i = 0; i < count; i ++)
+            {
+              if (!strings[i].is_obj() || strings[i].as_obj()->type() != Type::type_string)
+                RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand type for string concatenation: {}", strings[i].type()));
+              length += static_cast<ObjString*>(strings[i].as_obj())->byte_length();
+            }
+
+            string_t bytes;
+            bytes.reserve(length);
+            for (size_t i = 0; i < count; i ++)
+            {
+              auto string = static_cast<ObjString*>(strings[i].as_obj());
+              bytes.append(string->view());
+            }
+
+            auto string = allocate_string(bytes.c_str());
+            stack_top_ -= count;
+            push(Value::of_obj(string));
+            NEXT();
+          }
+
+          CASE(CAPTURE)
+          {
+            auto& right = peek(0);
+            auto& left = peek(1);
+            if (!left.is_obj() || left.as_obj()->type() != Type::type_string || !right.is_obj() || right.as_obj()->type() != Type::type_string)
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for capture: {} and {}", left.type(), right.type()));
+
+            // Capture the groups of the pattern, or the whole match if the pattern has no groups
+            auto subject = static_cast<ObjString*>(left.as_obj());
+            auto& regex = utils::Regex::cached(string_t(static_cast<ObjString*>(right.as_obj())->view()));
+            auto match = regex.match(subject->view());
+            size_t first = regex.group_count() > 1 ? 1 : 0;
+            size_t count = match.success() ? regex.group_count() - first : 0;
+
+            // Push the sequence before adding the groups as slices of the subject, so both stay reachable during a collection
+            auto sequence = allocate_sequence(nullptr, 0);
+            push(Value::of_obj(sequence));
+            for (size_t i = 0; i < count; i ++)
+            {
+              // Trailing groups that didn't participate in the match are not reported by the match
+              auto index = first + i;
+              auto group = index < match.group_count() ? std::make_optional(match.group(static_cast<int>(index))) : std::nullopt;
+              if (group.has_value() && group->success())
+                sequence->add(Value::of_obj(allocate_slice(subject, group->start(), group->length())));
+              else
+                sequence->add(Value::value_nothing);
+            }
+
+            stack_top_ -= 3;
+            push(Value::of_obj(sequence));
+            NEXT();
+          }
+
+          // Unary operators
+          CASE(NEGATE)
+          {
+            auto& right = peek();
+            if (right.is_int())
+              right = Value::of_int(-right.as_int());
+            else if (right.is_float())
+              right = Value::of_float(-right.as_float());
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand type for unary operator -: {}", right.type()));
+            NEXT();
+          }
+
+          CASE(LENGTH)
+          {
+            auto& right = peek();
+            if (right.is_obj() && right.as_obj()->type() == Type::type_string)
+              right = Value::of_int(static_cast<ObjString*>(right.as_obj())->length());
+            else if (right.is_obj() && right.as_obj()->type() == Type::type_sequence)
+              right = Value::of_int(static_cast<ObjSequence*>(right.as_obj())->length());
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand type for unary operator #: {}", right.type()));
+            NEXT();
+          }
+
+          CASE(STRING)
+          {
+            auto string = allocate_string(format(peek()).c_str());
+            peek() = Value::of_obj(string);
+            NEXT();
+          }
+
+          CASE(NOT)
+            peek() = Value::of_bool(is_falsey(peek()));
+            NEXT();
+
+          // Binary operators
+          CASE(MULTIPLY)
+          {
+            auto right = pop();
+            auto& left = peek();
+            if (left.is_int() && right.is_int())
+              left = Value::of_int(left.as_int() * right.as_int());
+            else if (left.is_float() && right.is_float())
+              left = Value::of_float(left.as_float() * right.as_float());
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for binary operator *: {} and {}", left.type(), right.type()));
+            NEXT();
+          }
+
+          CASE(DIVIDE)
+          {
+            auto right = pop();
+            auto& left = peek();
+            if (left.is_int() && right.is_int())
+              left = Value::of_float(static_cast<dauw_float_t>(left.as_int()) / static_cast<dauw_float_t>(right.as_int()));
+            else if (left.is_float() && right.is_float())
+              left = Value::of_float(left.as_float() / right.as_float());
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for binary operator /: {} and {}", left.type(), right.type()));
+            NEXT();
+          }
+
+          CASE(QUOTIENT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            if (left.is_int() && right.is_int())
+              left = Value::of_int(utils::floordiv(left.as_int(), right.as_int()));
+            else if (left.is_float() && right.is_float())
+              left = Value::of_float(utils::floordiv(left.as_float(), right.as_float()));
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for binary operator //: {} and {}", left.type(), right.type()));
+            NEXT();
+          }
+
+          CASE(REMAINDER)
+          {
+            auto right = pop();
+            auto& left = peek();
+            if (left.is_int() && right.is_int())
+              left = Value::of_int(utils::floormod(left.as_int(), right.as_int()));
+            else if (left.is_float() && right.is_float())
+              left = Value::of_float(utils::floormod(left.as_float(), right.as_float()));
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for binary operator %: {} and {}", left.type(), right.type()));
+            NEXT();
+          }
+
+          CASE(ADD)
+          {
+            auto& right = peek(0);
+            auto& left = peek(1);
+            if (left.is_int() && right.is_int())
+              left = Value::of_int(left.as_int() + right.as_int());
+            else if (left.is_float() && right.is_float())
+              left = Value::of_float(left.as_float() + right.as_float());
+            else if (left.is_obj() && left.as_obj()->type() == Type::type_string && right.is_obj() && right.as_obj()->type() == Type::type_string)
+            {
+              auto bytes = string_t(static_cast<ObjString*>(left.as_obj())->view()).append(static_cast<ObjString*>(right.as_obj())->view());
+              left = Value::of_obj(allocate_string(bytes.c_str()));
+            }
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for binary operator +: {} and {}", left.type(), right.type()));
+            stack_top_ --;
+            NEXT();
+          }
+
+          CASE(SUBTRACT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            if (left.is_int() && right.is_int())
+              left = Value::of_int(left.as_int() - right.as_int());
+            else if (left.is_float() && right.is_float())
+              left = Value::of_float(left.as_float() - right.as_float());
+            else
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for binary operator -: {} and {}", left.type(), right.type()));
+            NEXT();
+          }
+
+          CASE(COMPARE)
+          CASE(LESS)
+          CASE(LESS_EQUAL)
+          CASE(GREATER)
+          CASE(GREATER_EQUAL)
+          {
+            auto op = static_cast<OpCode>(ip[-1]);
+            auto right = pop();
+            auto& left = peek();
+
+            dauw_int_t comparison;
+            if (!compare(left, right, comparison))
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for comparison: {} and {}", left.type(), right.type()));
+
+            if (op == OpCode::COMPARE)
+              left = Value::of_int(comparison);
+            else if (op == OpCode::LESS)
+              left = Value::of_bool(comparison < 0);
+            else if (op == OpCode::LESS_EQUAL)
+              left = Value::of_bool(comparison <= 0);
+            else if (op == OpCode::GREATER)
+              left = Value::of_bool(comparison > 0);
+            else
+              left = Value::of_bool(comparison >= 0);
+            NEXT();
+          }
+
+          CASE(MATCH)
+          CASE(NOT_MATCH)
+          {
+            auto op = static_cast<OpCode>(ip[-1]);
+            auto right = pop();
+            auto& left = peek();
+
+            dauw_bool_t matches;
+            if (!match(left, right, matches))
+              RUNTIME_ERROR(RuntimeError, fmt::format("Unsupported operand types for match: {} and {}", left.type(), right.type()));
+
+            left = Value::of_bool(op == OpCode::MATCH ? matches : !matches);
+            NEXT();
+          }
+
+          CASE(EQUAL)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(equals(left, right));
+            NEXT();
+          }
+
+          CASE(NOT_EQUAL)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(!equals(left, right));
+            NEXT();
+          }
+
+          CASE(IDENTICAL)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left == right);
+            NEXT();
+          }
+
+          CASE(NOT_IDENTICAL)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left != right);
+            NEXT();
+          }
+
+          // Operators specialized for operands of which the resolved type is known
+          CASE(NEGATE_INT)
+          {
+            auto& right = peek();
+            right = Value::of_int(-right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(NEGATE_FLOAT)
+          {
+            auto& right = peek();
+            right = Value::of_float(-right.as_float_unchecked());
+            NEXT();
+          }
+
+          CASE(MULTIPLY_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_int(left.as_int_unchecked() * right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(MULTIPLY_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_float(left.as_float_unchecked() * right.as_float_unchecked());
+            NEXT();
+          }
+
+          CASE(DIVIDE_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_float(static_cast<dauw_float_t>(left.as_int_unchecked()) / static_cast<dauw_float_t>(right.as_int_unchecked()));
+            NEXT();
+          }
+
+          CASE(DIVIDE_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_float(left.as_float_unchecked() / right.as_float_unchecked());
+            NEXT();
+          }
+
+          CASE(QUOTIENT_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_int(utils::floordiv(left.as_int_unchecked(), right.as_int_unchecked()));
+            NEXT();
+          }
+
+          CASE(QUOTIENT_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_float(utils::floordiv(left.as_float_unchecked(), right.as_float_unchecked()));
+            NEXT();
+          }
+
+          CASE(REMAINDER_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_int(utils::floormod(left.as_int_unchecked(), right.as_int_unchecked()));
+            NEXT();
+          }
+
+          CASE(REMAINDER_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_float(utils::floormod(left.as_float_unchecked(), right.as_float_unchecked()));
+            NEXT();
+          }
+
+          CASE(ADD_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_int(left.as_int_unchecked() + right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(ADD_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_float(left.as_float_unchecked() + right.as_float_unchecked());
+            NEXT();
+          }
+
+          CASE(SUBTRACT_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_int(left.as_int_unchecked() - right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(SUBTRACT_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_float(left.as_float_unchecked() - right.as_float_unchecked());
+            NEXT();
+          }
+
+          CASE(LESS_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left.as_int_unchecked() < right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(LESS_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(compare_float(left.as_float_unchecked(), right.as_float_unchecked()) < 0);
+            NEXT();
+          }
+
+          CASE(LESS_EQUAL_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left.as_int_unchecked() <= right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(LESS_EQUAL_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(compare_float(left.as_float_unchecked(), right.as_float_unchecked()) <= 0);
+            NEXT();
+          }
+
+          CASE(GREATER_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left.as_int_unchecked() > right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(GREATER_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(compare_float(left.as_float_unchecked(), right.as_float_unchecked()) > 0);
+            NEXT();
+          }
+
+          CASE(GREATER_EQUAL_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left.as_int_unchecked() >= right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(GREATER_EQUAL_FLOAT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(compare_float(left.as_float_unchecked(), right.as_float_unchecked()) >= 0);
+            NEXT();
+          }
+
+          CASE(EQUAL_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left.as_int_unchecked() == right.as_int_unchecked());
+            NEXT();
+          }
+
+          CASE(NOT_EQUAL_INT)
+          {
+            auto right = pop();
+            auto& left = peek();
+            left = Value::of_bool(left.as_int_unchecked() != right.as_int_unchecked());
+            NEXT();
+          }
+
+          // Int operators that read their operands from registers
+          CASE(ADD_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_int(left + right));
+            NEXT();
+          }
+
+          CASE(ADD_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_int(left + right));
+            NEXT();
+          }
+
+          CASE(SUBTRACT_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_int(left - right));
+            NEXT();
+          }
+
+          CASE(SUBTRACT_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_int(left - right));
+            NEXT();
+          }
+
+          CASE(MULTIPLY_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_int(left * right));
+            NEXT();
+          }
+
+          CASE(MULTIPLY_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_int(left * right));
+            NEXT();
+          }
+
+          CASE(LESS_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_bool(left < right));
+            NEXT();
+          }
+
+          CASE(LESS_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_bool(left < right));
+            NEXT();
+          }
+
+          CASE(LESS_EQUAL_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_bool(left <= right));
+            NEXT();
+          }
+
+          CASE(LESS_EQUAL_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_bool(left <= right));
+            NEXT();
+          }
+
+          CASE(GREATER_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_bool(left > right));
+            NEXT();
+          }
+
+          CASE(GREATER_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_bool(left > right));
+            NEXT();
+          }
+
+          CASE(GREATER_EQUAL_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_bool(left >= right));
+            NEXT();
+          }
+
+          CASE(GREATER_EQUAL_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_bool(left >= right));
+            NEXT();
+          }
+
+          CASE(EQUAL_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_bool(left == right));
+            NEXT();
+          }
+
+          CASE(EQUAL_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_bool(left == right));
+            NEXT();
+          }
+
+          CASE(NOT_EQUAL_INT_LL)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = frame->slots()[READ_BYTE()].as_int_unchecked();
+            push(Value::of_bool(left != right));
+            NEXT();
+          }
+
+          CASE(NOT_EQUAL_INT_LC)
+          {
+            auto left = frame->slots()[READ_BYTE()].as_int_unchecked();
+            auto right = constants[READ_U16()].as_int_unchecked();
+            push(Value::of_bool(left != right));
+            NEXT();
+          }
+
+          // Control flow
+          CASE(JUMP)
+          {
+            auto offset = READ_U16();
+            ip += offset;
+            NEXT();
+          }
+
+          CASE(JUMP_IF_FALSE)
+          {
+            auto offset = READ_U16();
+            if (is_falsey(peek()))
+              ip += offset;
+            NEXT();
+          }
+
+          CASE(JUMP_IF_TRUE)
+          {
+            auto offset = READ_U16();
+            if (!is_falsey(peek()))
+              ip += offset;
+            NEXT();
+          }
+
+          CASE(LOOP)
+          {
+            auto offset = READ_U16();
+            ip -= offset;
+            NEXT();
+          }
+
+          // Functions
+          CASE(CALL)
+          {
+            auto arg_count = READ_BYTE();
+            SAVE_FRAME();
+            if (!call(peek(arg_count), arg_count))
+              return false;
+            LOAD_FRAME();
+            NEXT();
+          }
+
+          CASE(RETURN)
+          {
+            auto value = pop();
+            frame_count_ --;
+
+            // Check if the outermost frame returned
+            if (frame_count_ == 0)
+            {
+              stack_top_ = stack_.data();
+              result = value;
+              return true;
+            }
+
+            // Discard the slots of the frame and push the returned value
+            stack_top_ = frame->slots();
+            push(value);
+            LOAD_FRAME();
+            NEXT();
+          }
+
+          // Builtins
+          CASE(ECHO)
+            fmt::print("{}\n", format(peek()));
+            peek() = Value::value_nothing;
+            NEXT();
+
+          // Unknown operation code
+          CASE_UNKNOWN()
+            RUNTIME_ERROR(RuntimeError, fmt::format("Unknown operation code {:#04x}", ip[-1]));
+        }
+      }
+    }
+    catch (ValueOverflowException& ex)
+    {
+      RUNTIME_ERROR(ValueOverflowError, ex.message());
+    }
+    catch (ValueException& ex)
+    {
+      RUNTIME_ERROR(RuntimeError, ex.message());
+    }
+    catch (utils::DivisionByZeroException& ex)
+    {
+      RUNTIME_ERROR(DivisionByZeroError, ex.message());
+    }
+    catch (utils::ArithmeticException& ex)
+    {
+      RUNTIME_ERROR(ArithmeticError, ex.message());
+    }
+    catch (utils::RegexException& ex)
+    {
+      RUNTIME_ERROR(RuntimeError, ex.message());
+    }
+
+    #undef READ_BYTE
+    #undef READ_U16
+    #undef SAVE_FRAME
+    #undef LOAD_FRAME
+    #undef RUNTIME_ERROR
+    #undef COUNT_INSTRUCTION
+    #undef DISPATCH
+    #undef CASE
+    #undef CASE_UNKNOWN
+    #undef NEXT
+  }
+
+  // --------------------------------------------------------------------------
+  // OPERATOR FUNCTIONS
+  // --------------------------------------------------------------------------
+
+  // Return the result of comparing two values
+  bool VM::compare(Value left, Value right, dauw_int_t& result)
+  {
+    if (left.is_int() && right.is_int())
+    {
+      result = utils::sign(left.as_int() - right.as_int());
+      return true;
+    }
+    else if (left.is_float() && right.is_float())
+    {
+      result = compare_float(left.as_float(), right.as_float());
+      return true;
+    }
+    else if (left.is_obj() && left.as_obj()->type() == Type::type_string && right.is_obj() && right.as_obj()->type() == Type::type_string)
+    {
+      result = utils::sign(static_cast<dauw_int_t>(static_cast<ObjString*>(left.as_obj())->compare(*static_cast<ObjString*>(right.as_obj()))));
+      return true;
+    }
+    else
+      return false;
+  }
+
+  // Return the result of comparing two floats, where not-a-number compares equal to itself and greater than any other float
+  dauw_int_t VM::compare_float(dauw_float_t left, dauw_float_t right)
+  {
+    if (std::isnan(left) && std::isnan(right))
+      return 0;
+    else if (std::isnan(left))
+      return 1;
+    else if (std::isnan(right))
+      return -1;
+    else if (left < right)
+      return -1;
+    else if (left > right)
+      return 1;
+    else
+      return 0;
+  }
+
+  // Return the result of matching a value against a pattern
+  bool VM::match(Value left, Value right, dauw_bool_t& result)
+  {
+    if (left.is_obj() && left.as_obj()->type() == Type::type_string && right.is_obj() && right.as_obj()->type() == Type::type_string)
+    {
+      auto& regex = utils::Regex::cached(string_t(static_cast<ObjString*>(right.as_obj())->view()));
+      result = regex.matches(static_cast<ObjString*>(left.as_obj())->view());
+      return true;
+    }
+    else
+      return false;
+  }
+
+  // Return the result of checking if two values are equal
+  dauw_bool_t VM::equals(Value left, Value right)
+  {
+    // Strings are interned, so reference equality also covers equality of strings
+    return left == right;
+  }
+
+  // Return if a value is considered false in a condition
+  bool VM::is_falsey(Value value)
+  {
+    return value.is_nothing() || value.is_false();
+  }
+
+  // --------------------------------------------------------------------------
+  // GARBAGE COLLECTION FUNCTIONS
+  // --------------------------------------------------------------------------
+
+  // Mark an object as reachable
+  void VM::mark_object(Obj* object)
+  {
+    if (object == nullptr || object->marked())
+      return;
+
+    object->set_marked(true);
+    gray_objects_.push_back(object);
+  }
+
+  // Mark the object in a value as reachable
+  void VM::mark_value(Value value)
+  {
+    if (value.is_obj())
+      mark_object(value.as_obj());
+  }
+
+  // Mark the objects that are reachable from the roots of the virtual machine
+  void VM::mark_roots()
+  {
+    // Mark the values on the stack
+    for (auto slot = stack_.data(); slot < stack_top_; slot ++)
+      mark_value(*slot);
+
+    // Mark the functions of the active call frames
+    for (size_t i = 0; i < frame_count_; i ++)
+      mark_object(frames_[i].function());
+
+    // Mark the values of the globals
+    for (auto global : globals_)
+      mark_value(global);
+  }
+
+  // Trace the references of the marked objects until no unvisited objects remain
+  void VM::trace_references()
+  {
+    std::vector<Obj*> references;
+    while (!gray_objects_.empty())
+    {
+      auto object = gray_objects_.back();
+      gray_objects_.pop_back();
+
+      references.clear();
+      object->trace(references);
+      for (auto reference : references)
+        mark_object(reference);
+    }
+  }
+
+  // Free the objects that are not marked and unmark the remaining objects
+  void VM::sweep()
+  {
+    bytes_allocated_ = 0;
+    objects_.remove_if([this](Obj* object) {
+      if (!object->marked())
+      {
+        free_object(object);
+        return true;
+      }
+
+      object->set_marked(false);
+      bytes_allocated_ += object->size();
+      return false;
+    });
+  }
 }
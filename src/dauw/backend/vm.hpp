@@ -1,38 +1,225 @@
 #pragma once
 
 #include <dauw/common.hpp>
+#include <dauw/errors.hpp>
+#include <dauw/backend/chunk.hpp>
+#include <dauw/frontend/location.hpp>
+#include <dauw/internals/format.hpp>
+#include <dauw/internals/function_object.hpp>
+#include <dauw/internals/record_object.hpp>
+#include <dauw/internals/sequence_object.hpp>
 #include <dauw/internals/string_object.hpp>
+#include <dauw/internals/string_table.hpp>
 #include <dauw/internals/object.hpp>
+#include <dauw/internals/value.hpp>
+#include <dauw/utils/math.hpp>
+#include <dauw/utils/regex.hpp>
 
+#include <algorithm>
 #include <forward_list>
 
+
+// Defines for the limits of the virtual machine
+#define DAUW_VM_FRAMES_MAX 256
+#define DAUW_VM_STACK_MAX (DAUW_VM_FRAMES_MAX * 256)
+
+// Defines for the defaults of the garbage collector
+#ifndef DAUW_GC_INITIAL_THRESHOLD
+  #define DAUW_GC_INITIAL_THRESHOLD (1024 * 1024)
+#endif
+
+#ifndef DAUW_GC_GROWTH_FACTOR
+  #define DAUW_GC_GROWTH_FACTOR 2.0
+#endif
+
+// Define for dispatching the operations with computed goto, which is enabled by the build and requires the labels as values extension of GCC and Clang
+#if defined(DAUW_VM_COMPUTED_GOTO) && !defined(__GNUC__)
+  #undef DAUW_VM_COMPUTED_GOTO
+#endif
+
+
 namespace dauw
 {
+  // Class that defines a call frame of the virtual machine
+  class VMFrame
+  {
+    private:
+      // The function that is executed in the frame
+      ObjFunction* function_;
+
+      // The instruction pointer of the frame
+      uint8_t* ip_;
+
+      // The first slot of the frame on the stack
+      Value* slots_;
+
+
+    public:
+      // Constructor
+      VMFrame(ObjFunction* function, Value* slots);
+      VMFrame();
+
+      // Return the function that is executed in the frame
+      ObjFunction* function();
+
+      // Return the instruction pointer of the frame
+      uint8_t*& ip();
+
+      // Return the first slot of the frame on the stack
+      Value* slots();
+
+      // Return the location of the instruction that is currently executed
+      Location& location();
+  };
+
+
   // Class that defines the virtual machine
-  class VM
+  class VM : public ReporterAware
   {
     private:
       // Linked list of defined objects
       std::forward_list<Obj*> objects_;
 
+      // The objects that are marked, but of which the references are not traced yet
+      std::vector<Obj*> gray_objects_;
+
+      // The table of interned strings, which doesn't keep its strings reachable
+      StringTable strings_;
+
+      // The number of bytes that are owned by the defined objects
+      size_t bytes_allocated_;
+
+      // The number of allocated bytes at which the next collection is triggered
+      size_t next_collection_;
+
+      // The number of allocated bytes at which the first collection is triggered
+      size_t gc_initial_threshold_;
+
+      // The factor by which the heap may grow relative to the surviving bytes before the next collection
+      double gc_growth_factor_;
+
+      // The operand stack of the virtual machine
+      std::vector<Value> stack_;
+
+      // Pointer to the slot past the top value of the stack
+      Value* stack_top_;
+
+      // The call frames of the virtual machine
+      std::vector<VMFrame> frames_;
+
+      // The number of active call frames
+      size_t frame_count_;
+
+      // The values of the global names
+      std::vector<Value> globals_;
+
+      // The names of the globals mapped to their index
+      std::unordered_map<string_t, size_t> global_indexes_;
+
+      // The number of dispatched instructions, which is only counted if enabled by the build
+      size_t instruction_count_;
+
+
+      // Push and pop values from the stack
+      void push(Value value);
+      Value pop();
+      Value& peek(size_t distance = 0);
+
+      // Call a function with the specified number of arguments on the stack
+      bool call(Value callee, size_t arg_count);
+
+      // Execute the call frames until the outermost frame returns
+      bool execute(Value& result);
+
+      // Report a runtime error at the current instruction
+      template <typename T>
+      inline void runtime_error(string_t message)
+      {
+        report<T>(frames_[frame_count_ - 1].location(), message);
+      }
+
+      // Return the result of comparing two values
+      bool compare(Value left, Value right, dauw_int_t& result);
+
+      // Return the result of matching a value against a pattern
+      bool match(Value left, Value right, dauw_bool_t& result);
+
+      // Return the result of checking if two values are equal
+      dauw_bool_t equals(Value left, Value right);
+
+      // Mark an object or the object in a value as reachable
+      void mark_object(Obj* object);
+      void mark_value(Value value);
+
+      // Mark the objects that are reachable from the roots of the virtual machine
+      void mark_roots();
+
+      // Trace the references of the marked objects until no unvisited objects remain
+      void trace_references();
+
+      // Free the objects that are not marked and unmark the remaining objects
+      void sweep();
+
 
     public:
       // Constructor
-      VM();
+      VM(Reporter* reporter);
 
       // Destructor
       ~VM();
 
-      // Collect the marked objects
+      // Collect the objects that are not reachable from the stack, the call frames or the globals
       void collect();
 
-      // Append an object
+      // Return the number of bytes that are owned by the defined objects
+      size_t bytes_allocated();
+
+      // Set the number of allocated bytes at which the first collection is triggered
+      void set_gc_initial_threshold(size_t threshold);
+
+      // Set the factor by which the heap may grow relative to the surviving bytes before the next collection
+      void set_gc_growth_factor(double factor);
+
+      // Append an object and trigger a collection if the allocation threshold has been reached
       void append_object(Obj* object);
 
       // Free an object
       void free_object(Obj* object);
 
-      // Allocate a string
+      // Allocate a string, or return the interned string with the same characters
       ObjString* allocate_string(const char* bytes);
+
+      // Allocate a slice of a string at the specified byte offset and length at code point boundaries, or return the interned string with the same characters
+      ObjString* allocate_slice(ObjString* parent, size_t offset, size_t length);
+
+      // Allocate a function
+      ObjFunction* allocate_function(string_t name, size_t arity);
+
+      // Allocate a sequence from an array of items
+      ObjSequence* allocate_sequence(const Value* items, size_t count);
+
+      // Allocate a record with the specified shape from an array of slot values
+      ObjRecord* allocate_record(Shape* shape, const Value* values);
+
+      // Return the index of a global name, or define it if it doesn't exist yet
+      size_t global_index(string_t name);
+
+      // Return if a global name has been defined
+      bool has_global(string_t name);
+
+      // Return the names of the globals in index order
+      std::vector<string_t> global_names();
+
+      // Return the number of dispatched instructions
+      size_t instruction_count();
+
+      // Run a compiled script function and return if it completed without errors
+      bool run(ObjFunction* function);
+
+      // Return the result of comparing two floats, where not-a-number compares equal to itself and greater than any other float
+      static dauw_int_t compare_float(dauw_float_t left, dauw_float_t right);
+
+      // Return if a value is considered false in a condition
+      static bool is_falsey(Value value);
   };
 }
@@ -4,7 +4,8 @@
 namespace dauw
 {
   // Constructor
-  Dauw::Dauw()
+  Dauw::Dauw(bool use_interpreter, bool use_cache)
+    : use_interpreter_(use_interpreter), use_cache_(use_cache)
   {
   }
 
@@ -16,8 +17,20 @@ namespace dauw
     // Create the error reporter
     auto reporter = std::make_shared<Reporter>(source);
 
-    // Tokenize the source string
-    auto tokens = Lexer(reporter.get(), source).tokenize();
+    // Run the cached bytecode if the source file has been compiled before and didn't change since
+    auto use_cache = use_cache_ && !use_interpreter_ && std::filesystem::is_regular_file(source->file());
+    if (use_cache)
+    {
+      auto vm = std::make_unique<VM>(reporter.get());
+      auto function = BytecodeCache(source).load(vm.get());
+      if (function != nullptr)
+        return run_function_(reporter.get(), vm.get(), function);
+    }
+
+    // Parse the tokens that are streamed from the lexer into nodes in the arena of the source and exit the application if a lexer or parser error occurred
+    Lexer lexer(reporter.get(), source);
+    Arena arena;
+    auto expr = Parser(reporter.get(), &arena, &lexer).parse();
     if (reporter->has_errors())
     {
       reporter->print_errors();
@@ -25,18 +38,38 @@ namespace dauw
       return DAUW_EXIT_DATAERR;
     }
 
-    // Parse the tokens and exit the application if a parser error occurred
-    auto expr = Parser(reporter.get(), tokens).parse();
+    // Resolve the types of the expression
+    TypeResolver(reporter.get()).resolve(expr);
     if (reporter->has_errors())
     {
       reporter->print_errors();
       reporter->clear_errors();
-      return DAUW_EXIT_DATAERR;
+      return DAUW_EXIT_SOFTWAREERR;
     }
 
-    // Resolve the types of the expression
-    auto type_resolver = std::make_shared<TypeResolver>(reporter.get());
-    type_resolver->resolve(expr);
+    // Evaluate the expression using the interpreter if requested
+    if (use_interpreter_)
+    {
+      // Evaluate the expression and exit the application if a runtime error occurred
+      Interpreter(reporter.get()).evaluate(expr);
+      if (reporter->has_errors())
+      {
+        reporter->print_errors();
+        reporter->clear_errors();
+        return DAUW_EXIT_SOFTWAREERR;
+      }
+
+      // Quit with an ok exit code
+      return DAUW_EXIT_OK;
+    }
+
+    // Fold the constant subexpressions of the expression, which is only done for compiled code, since the interpreter
+    // stores its results in the computed values of the expressions
+    ConstantFolder().fold(expr);
+
+    // Compile the expression to bytecode and exit the application if a compiler error occurred
+    auto vm = std::make_unique<VM>(reporter.get());
+    auto function = Compiler(reporter.get(), vm.get()).compile(expr);
     if (reporter->has_errors())
     {
       reporter->print_errors();
@@ -44,9 +77,22 @@ namespace dauw
       return DAUW_EXIT_SOFTWAREERR;
     }
 
-    // Evaluate the expression and exit the application if a runtime error occurred
-    auto interpreter = std::make_shared<Interpreter>(reporter.get());
-    interpreter->evaluate(expr);
+    // Store the bytecode in the cache, which is not fatal if it fails
+    if (use_cache)
+      BytecodeCache(source).store(function, vm.get());
+
+    // Run the bytecode
+    return run_function_(reporter.get(), vm.get(), function);
+  }
+
+  // Run a compiled script function on a virtual machine and return the exit code
+  int Dauw::run_function_(Reporter* reporter, VM* vm, ObjFunction* function)
+  {
+    // Run the bytecode and exit the application if a runtime error occurred
+    vm->run(function);
+#ifdef DAUW_VM_COUNT_INSTRUCTIONS
+    fmt::print(stderr, "Dispatched {} instructions\n", vm->instruction_count());
+#endif
     if (reporter->has_errors())
     {
       reporter->print_errors();
@@ -75,8 +121,15 @@ namespace dauw
       linenoise::AddHistory(line.c_str());
 
       // Run the line
-      auto source = Source::create("<prompt>", line);
-  		run(source);
+      try
+      {
+        auto source = Source::create("<prompt>", line);
+        run(source);
+      }
+      catch (SourceException& ex)
+      {
+        fmt::print(fmt::fg(fmt::color::crimson), "{}\n", ex.message());
+      }
   	}
 
     // Exit the loop normally
@@ -2,8 +2,12 @@
 
 #include <dauw/common.hpp>
 #include <dauw/errors.hpp>
+#include <dauw/backend/bytecode_cache.hpp>
+#include <dauw/backend/compiler.hpp>
+#include <dauw/backend/constant_folder.hpp>
 #include <dauw/backend/interpreter.hpp>
 #include <dauw/backend/type_resolver.hpp>
+#include <dauw/backend/vm.hpp>
 #include <dauw/frontend/lexer.hpp>
 #include <dauw/frontend/location.hpp>
 #include <dauw/frontend/parser.hpp>
@@ -20,9 +24,21 @@ namespace dauw
   // Class that defines the high-level code of the application
   class Dauw
   {
+    private:
+      // Indicate if the code is evaluated by the tree-walking interpreter instead of the virtual machine
+      bool use_interpreter_;
+
+      // Indicate if the compiled bytecode of source files is cached on disk
+      bool use_cache_;
+
+
+      // Run a compiled script function on a virtual machine and return the exit code
+      int run_function_(Reporter* reporter, VM* vm, ObjFunction* function);
+
+
     public:
       // Constructor
-      Dauw();
+      Dauw(bool use_interpreter = false, bool use_cache = true);
 
       // Run code from a source file
       int run(source_ptr source);
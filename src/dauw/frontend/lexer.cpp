@@ -22,15 +22,20 @@ namespace dauw
   }
 
   // Return the regular expression pattern of the rule
-  utils::Regex LexerRule::pattern()
+  utils::Regex& LexerRule::pattern()
   {
     return pattern_;
   }
 
-  // Return the replacement of the rule based on a match
-  string_t LexerRule::replace(utils::RegexMatch match)
+  // Return the replacement of the rule based on the group offsets of a match in a line
+  string_t LexerRule::replace(string_view_t line, size_t* offsets)
   {
-    return group_.has_value() ? match.group(group_.value()).value() : "";
+    if (!group_.has_value() || offsets[2 * group_.value()] == PCRE2_UNSET)
+      return "";
+
+    auto start = offsets[2 * group_.value()];
+    auto end = offsets[2 * group_.value() + 1];
+    return string_t(line.substr(start, end - start));
   }
 
   // --------------------------------------------------------------------------
@@ -82,6 +87,7 @@ namespace dauw
     LexerRule(TokenKind::OPERATOR_GREATER_EQUAL, utils::Regex(">=")),
     LexerRule(TokenKind::OPERATOR_MATCH, utils::Regex("=~")),
     LexerRule(TokenKind::OPERATOR_NOT_MATCH, utils::Regex("!~")),
+    LexerRule(TokenKind::OPERATOR_CAPTURE, utils::Regex("~")),
     LexerRule(TokenKind::OPERATOR_EQUAL, utils::Regex("==")),
     LexerRule(TokenKind::OPERATOR_NOT_EQUAL, utils::Regex("!=")),
     LexerRule(TokenKind::OPERATOR_IDENTICAL, utils::Regex("===")),
@@ -118,151 +124,707 @@ namespace dauw
     LexerRule(TokenKind::LITERAL_REGEX, regex_pattern_, 0),
   });
 
+  // Initialize the character classes for the scanner
+  const std::array<uint8_t, 256> Lexer::char_classes_ = []() {
+    std::array<uint8_t, 256> classes = {};
+    classes[' '] |= CHAR_WHITESPACE;
+    classes['\t'] |= CHAR_WHITESPACE;
+    for (auto c = '0'; c <= '9'; c ++)
+      classes[c] |= CHAR_DIGIT | CHAR_HEX_DIGIT | CHAR_IDENTIFIER;
+    for (auto c = 'A'; c <= 'Z'; c ++)
+      classes[c] |= CHAR_LETTER | CHAR_IDENTIFIER_START | CHAR_IDENTIFIER;
+    for (auto c = 'a'; c <= 'z'; c ++)
+      classes[c] |= CHAR_LETTER | CHAR_IDENTIFIER_START | CHAR_IDENTIFIER;
+    for (auto c = 'A'; c <= 'F'; c ++)
+      classes[c] |= CHAR_HEX_DIGIT;
+    for (auto c = 'a'; c <= 'f'; c ++)
+      classes[c] |= CHAR_HEX_DIGIT;
+    classes['_'] |= CHAR_IDENTIFIER_START | CHAR_IDENTIFIER;
+    return classes;
+  }();
+
 
   // Constructor for the lexer
-  Lexer::Lexer(Reporter* reporter, source_ptr source)
-    : ReporterAware(reporter), source_(source)
+  Lexer::Lexer(Reporter* reporter, source_ptr source, LexerMode mode)
+    : ReporterAware(reporter), source_(source), mode_(mode), indents_({0}), at_line_start_(true), at_end_(false), end_line_(source->line_count()), thread_count_(std::thread::hardware_concurrency())
+  {
+  }
+
+  // Constructor for a lexer that scans a chunk of lines of the source
+  Lexer::Lexer(Reporter* reporter, source_ptr source, LexerMode mode, size_t begin_line, size_t end_line)
+    : ReporterAware(reporter), source_(source), mode_(mode), location_(begin_line, 0), indents_({0}), at_line_start_(true), at_end_(false), end_line_(end_line), thread_count_(1)
+  {
+  }
+
+  // Destructor for the lexer
+  Lexer::~Lexer()
+  {
+    stop_parallel_();
+  }
+
+  // Set the number of threads that scan the source in parallel before the first token, where 1 disables parallel scanning
+  void Lexer::set_thread_count(size_t thread_count)
   {
+    thread_count_ = thread_count;
+  }
+
+  // Return the next token of the source, scanning as much of the source as needed to produce it
+  Token Lexer::next_token()
+  {
+    // Scan until a token is available, and stop scanning the rest of the source when an error occurs
+    try
+    {
+      // Scan the whole source in parallel first if it is large enough
+      if (thread_count_ > 1 && source_->source().length() >= DAUW_LEXER_PARALLEL_MIN_SIZE)
+        scan_parallel_();
+
+      while (pending_.empty())
+      {
+        if (parallel_ != nullptr)
+          hand_chunk_();
+        else
+          scan_next_();
+      }
+    }
+    catch (SyntaxError& ex)
+    {
+      stop_parallel_();
+      pending_.clear();
+      at_end_ = true;
+      throw;
+    }
+
+    auto token = std::move(pending_.front());
+    pending_.pop_front();
+    return token;
   }
 
-  // Convert a string into a deque of tokens
+  // Convert the source into a deque of tokens at once
   Lexer::token_list_type Lexer::tokenize()
   {
-    // Initialize a deque to store the tokens
     token_list_type tokens;
 
-    // Initialize a stack to store the indentation levels
-    std::deque<int> indents({0});
+    try
+    {
+      do
+        tokens.push_back(next_token());
+      while (tokens.back().kind() != TokenKind::END);
+    }
+    catch (SyntaxError& ex)
+    {
+      return token_list_type({});
+    }
 
-    // ReInitialize a location for the lexer
-    Location location;
+    return tokens;
+  }
 
-    // Iterate over the lines in the source
-    for (auto line : source_->source_lines())
+  // Scan the next step of the source and add the resulting tokens to the pending tokens
+  void Lexer::scan_next_()
+  {
+    // Keep returning end tokens once the end of the source has been reached
+    if (at_end_)
     {
-      // Check for a shebang at the start of the source
-      if (line.rfind("#!", 0) == 0)
+      pending_.push_back(Token(TokenKind::END, location_));
+      return;
+    }
+
+    // Scan the start of a line
+    if (at_line_start_)
+    {
+      // Check for the end of the source, and add dedent tokens for the remaining indents and an end token
+      if (location_.line() >= end_line_)
       {
-        // If this is the first line of the source, then ignore the shebang, otherwise report an error
-        if (location.line() != 0)
+        while (indents_.back() > 0)
         {
-          report<SyntaxError>(location, "A shebang is only allowed at the first line of the source");
-          return token_list_type({});
+          indents_.pop_back();
+          pending_.push_back(Token(TokenKind::DEDENT, location_));
         }
 
+        pending_.push_back(Token(TokenKind::END, location_));
+        at_end_ = true;
+        return;
+      }
+
+      line_ = source_->line(location_.line());
+
+      // Check for a shebang at the start of the source
+      if (line_.rfind("#!", 0) == 0)
+      {
+        // If this is the first line of the source, then ignore the shebang, otherwise report an error
+        if (location_.line() != 0)
+          throw report<SyntaxError>(location_, "A shebang is only allowed at the first line of the source");
+
         // Increase the position to past the shebang
-        location.increase_line_();
-        continue;
+        location_.increase_line_();
+        return;
       }
 
       // Skip the line if it is empty or only contains whitespace
-      if (line.empty() || line.find_first_not_of(" \t\r\n") == string_t::npos)
+      if (line_.empty() || line_.find_first_not_of(" \t\r\n") == string_view_t::npos)
       {
-        location.increase_line_();
-        continue;
+        location_.increase_line_();
+        return;
       }
 
       // Calculate the indentation at the start of the line and add tokens accordingly
       int indent = 0;
-      for (auto indent_iterator = line.begin(); indent_iterator != line.end() && *indent_iterator == ' '; ++ indent_iterator)
+      for (auto indent_iterator = line_.begin(); indent_iterator != line_.end() && *indent_iterator == ' '; ++ indent_iterator)
         indent ++;
 
-      if (indent > indents.back())
+      if (indent > indents_.back())
       {
         // Check if the indent is on the first line, because that's an Error
-        if (location.line() == 0)
-        {
-          report<SyntaxError>(location, "The first line of the source should never be indented");
-          return token_list_type({});
-        }
+        if (location_.line() == 0)
+          throw report<SyntaxError>(location_, "The first line of the source should never be indented");
 
         // If the indent is bigger than the last indent, then add an indent token
-        indents.push_back(indent);
-        tokens.push_back(Token(TokenKind::INDENT, location));
+        indents_.push_back(indent);
+        pending_.push_back(Token(TokenKind::INDENT, location_));
       }
 
-      while (indent < indents.back())
+      while (indent < indents_.back())
       {
         // If the indent is smaller than the last indent, then add as much dedent tokens until the indent matches one on the stack
-        indents.pop_back();
-        tokens.push_back(Token(TokenKind::DEDENT, location));
+        indents_.pop_back();
+        pending_.push_back(Token(TokenKind::DEDENT, location_));
       }
 
-     // If the indent doesn't match the current indentation level, then report an error
-      if (indent != indents.back())
-      {
-        report<SyntaxError>(location, "The indentation does not match any outer indentation level");
-        return token_list_type({});
-      }
+      // If the indent doesn't match the current indentation level, then report an error
+      if (indent != indents_.back())
+        throw report<SyntaxError>(location_, "The indentation does not match any outer indentation level");
+
+      location_.increase_col_(indent);
+      at_line_start_ = false;
+      return;
+    }
+
+    // Scan the token at the current position of the line
+    if (location_.col() < line_.length())
+    {
+      auto length = mode_ == LexerMode::REGEX ? match_token(line_, location_, pending_) : scan_token(line_, location_, pending_);
+
+      // If there is no matched token, then we've encountered a syntax Error
+      if (length == 0)
+        throw report<SyntaxError>(location_, fmt::format("Invalid character '{}'", line_.substr(location_.col(), 1)));
 
-      location.increase_col_(indent);
+      // Increase the position to past the token
+      location_.increase_col_(length);
+      return;
+    }
+
+    // Add a newline at the end of the line and update the location to the next line
+    pending_.push_back(Token(TokenKind::NEWLINE, location_));
+    location_.increase_line_();
+    at_line_start_ = true;
+  }
 
-      // Iterate over the line
-      while (location.col() < line.length())
+  // Start scanning chunks of the source on multiple threads ahead of the parser
+  void Lexer::scan_parallel_()
+  {
+    // The source is only scanned in parallel once, before the first token
+    auto thread_count = thread_count_;
+    thread_count_ = 1;
+
+    // Split the source into chunks of bounded size, and fall back to scanning sequentially if there is only one chunk
+    auto lines = split_lines_(std::max(thread_count * DAUW_LEXER_CHUNKS_PER_THREAD, source_->source().length() / DAUW_LEXER_MAX_CHUNK_SIZE));
+    auto chunk_count = lines.size() - 1;
+    if (chunk_count < 2)
+      return;
+
+    // Only a bounded number of chunks are scanned ahead of the parser, so the peak memory doesn't grow with the size of the source
+    parallel_ = std::make_unique<LexerParallelScan>();
+    parallel_->lines = std::move(lines);
+    parallel_->chunks.resize(chunk_count);
+    parallel_->next_scanned = 0;
+    parallel_->next_handed = 0;
+    parallel_->chunks_ahead = thread_count * DAUW_LEXER_CHUNKS_AHEAD_PER_THREAD;
+    parallel_->stopped = false;
+
+    // Scan the chunks on the threads in source order, where every chunk has its own reporter because reporters are not shared between threads
+    auto scan = parallel_.get();
+    auto source = source_;
+    auto mode = mode_;
+    auto scan_chunks = [scan, source, mode]() {
+      std::unique_lock<std::mutex> lock(scan->mutex);
+      while (true)
       {
-        // Check for comments at the current position
-        auto comment_match = comment_pattern_.match(line, location.col(), utils::REGEX_MATCH_AT_BEGIN);
-        if (comment_match.success() && comment_match.group(1).success())
+        scan->chunk_handed.wait(lock, [scan]() {
+          return scan->stopped || scan->next_scanned >= scan->chunks.size() || scan->next_scanned < scan->next_handed + scan->chunks_ahead;
+        });
+        if (scan->stopped || scan->next_scanned >= scan->chunks.size())
+          return;
+
+        auto chunk = scan->next_scanned ++;
+        lock.unlock();
+
+        Reporter reporter(source);
+        Lexer lexer(&reporter, source, mode, scan->lines[chunk], scan->lines[chunk + 1]);
+        auto failed = false;
+        try
         {
-          tokens.push_back(Token(TokenKind::COMMENT, comment_match.group(1).value(), location));
-          location.increase_col_(comment_match.length());
-          continue;
+          while (!lexer.at_end_)
+            lexer.scan_next_();
         }
-
-        // Check for whitespaces at the current position
-        auto whitespace_match = whitespace_pattern_.match(line, location.col(), utils::REGEX_MATCH_AT_BEGIN);
-        if (whitespace_match.success())
+        catch (SyntaxError& ex)
         {
-          location.increase_col_(whitespace_match.length());
-          continue;
+          failed = true;
         }
 
-        // Iterate over the rules to see if they match
-        std::vector<std::tuple<Token, size_t>> matched_tokens;
-        for (auto rule : rules_)
-        {
-          auto rule_match = rule.pattern().match(line, location.col(), utils::REGEX_MATCH_AT_BEGIN);
-          if (rule_match.success())
-            matched_tokens.push_back(std::make_tuple(Token(rule.kind(), rule.replace(rule_match), location), rule_match.length()));
-        }
+        lock.lock();
+        scan->chunks[chunk].tokens = failed ? token_list_type() : std::move(lexer.pending_);
+        scan->chunks[chunk].scanned = true;
+        scan->chunks[chunk].failed = failed;
+        scan->chunk_scanned.notify_all();
+      }
+    };
+
+    for (size_t i = 0; i < std::min(thread_count, chunk_count); i ++)
+      parallel_->threads.emplace_back(scan_chunks);
+  }
+
+  // Wait for the next chunk of the parallel scan and add its stitched tokens to the pending tokens
+  void Lexer::hand_chunk_()
+  {
+    auto scan = parallel_.get();
+    auto index = scan->next_handed;
+    auto last = index == scan->chunks.size() - 1;
+
+    // Wait until the chunk is scanned and move its tokens out of the chunk, so a thread can scan the next chunk ahead
+    token_list_type tokens;
+    bool failed;
+    {
+      std::unique_lock<std::mutex> lock(scan->mutex);
+      auto& chunk = scan->chunks[index];
+      scan->chunk_scanned.wait(lock, [&chunk]() { return chunk.scanned; });
+
+      failed = chunk.failed;
+      tokens = std::move(chunk.tokens);
+      chunk.tokens = token_list_type();
+      scan->next_handed ++;
+      scan->chunk_handed.notify_all();
+    }
+
+    // If the chunk contains an error, then continue scanning sequentially from the start of the chunk, so the error is reported when its tokens are reached
+    if (failed)
+    {
+      location_ = Location(scan->lines[index], 0);
+      stop_parallel_();
+      return;
+    }
+
+    // Every chunk ends with the dedent tokens for its remaining indents, which are the same dedent tokens that the next line without indentation produces,
+    // followed by an end token that is only kept for the last chunk
+    if (!last)
+      tokens.pop_back();
+    std::move(tokens.begin(), tokens.end(), std::back_inserter(pending_));
+
+    if (last)
+    {
+      location_ = pending_.back().location();
+      at_end_ = true;
+      stop_parallel_();
+    }
+  }
+
+  // Stop the threads of the parallel scan and continue scanning sequentially
+  void Lexer::stop_parallel_()
+  {
+    if (parallel_ == nullptr)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(parallel_->mutex);
+      parallel_->stopped = true;
+    }
+    parallel_->chunk_handed.notify_all();
+
+    for (auto& thread : parallel_->threads)
+      thread.join();
+    parallel_.reset();
+  }
+
+  // Return the lines at which the source is split into at most the specified number of chunks, including the end line
+  std::vector<size_t> Lexer::split_lines_(size_t chunk_count)
+  {
+    auto source = source_->source();
+    auto min_chunk_length = source.length() / chunk_count;
+
+    std::vector<size_t> lines({0});
+    size_t chunk_offset = 0;
+    for (size_t index = 1; index < end_line_; index ++)
+    {
+      auto line = source_->line(index);
+      auto offset = static_cast<size_t>(line.data() - source.data());
+      if (offset - chunk_offset < min_chunk_length)
+        continue;
+
+      // Only split at a line without indentation, where the stack of indentation levels is always empty
+      if (line.empty() || line[0] == ' ' || line.find_first_not_of(" \t\r\n") == string_view_t::npos)
+        continue;
+
+      lines.push_back(index);
+      chunk_offset = offset;
+    }
+
+    lines.push_back(end_line_);
+    return lines;
+  }
+
+  // Return the kind of a keyword, or an identifier if the name is not a keyword
+  TokenKind Lexer::keyword_kind(const char* name, size_t length)
+  {
+    auto is = [name, length](const char* keyword) {
+      return std::strlen(keyword) == length && std::memcmp(name, keyword, length) == 0;
+    };
+
+    // Select the keywords to check by their first character
+    switch (name[0])
+    {
+      case 'a':
+        if (is("and")) return TokenKind::OPERATOR_LOGIC_AND;
+        break;
+
+      case 'd':
+        if (is("def")) return TokenKind::KEYWORD_DEF;
+        if (is("do")) return TokenKind::KEYWORD_DO;
+        break;
+
+      case 'e':
+        if (is("echo")) return TokenKind::KEYWORD_ECHO;
+        if (is("else")) return TokenKind::KEYWORD_ELSE;
+        break;
+
+      case 'f':
+        if (is("false")) return TokenKind::KEYWORD_FALSE;
+        if (is("for")) return TokenKind::KEYWORD_FOR;
+        break;
+
+      case 'i':
+        if (is("if")) return TokenKind::KEYWORD_IF;
+        if (is("in")) return TokenKind::KEYWORD_IN;
+        break;
+
+      case 'n':
+        if (is("not")) return TokenKind::OPERATOR_LOGIC_NOT;
+        if (is("nothing")) return TokenKind::KEYWORD_NOTHING;
+        break;
+
+      case 'o':
+        if (is("or")) return TokenKind::OPERATOR_LOGIC_OR;
+        break;
+
+      case 't':
+        if (is("then")) return TokenKind::KEYWORD_THEN;
+        if (is("true")) return TokenKind::KEYWORD_TRUE;
+        break;
+
+      case 'u':
+        if (is("until")) return TokenKind::KEYWORD_UNTIL;
+        break;
+
+      case 'w':
+        if (is("while")) return TokenKind::KEYWORD_WHILE;
+        break;
+    }
 
-        // If there are no matched tokens, then we've encountered a syntax Error
-        if (matched_tokens.empty())
+    return TokenKind::IDENTIFIER;
+  }
+
+  // Scan a token at the location in the line using the scanner, and return its length or zero if no token matched
+  size_t Lexer::scan_token(string_view_t line, Location& location, token_list_type& tokens)
+  {
+    // The scanner produces the same tokens as the regex rules: the longest match wins, and on a tie the rule that
+    // comes first in the rules of the lexer wins
+    const char* begin = line.data() + location.col();
+    const char* end = line.data() + line.length();
+    const char* p = begin;
+
+    // Lambda to add a token without a value and return its length
+    auto token = [&](TokenKind kind, size_t length) {
+      tokens.push_back(Token(kind, location));
+      return length;
+    };
+
+    switch (*p)
+    {
+      // Whitespace, which can be followed by a comment
+      case ' ':
+      case '\t':
+        while (p < end && is_class(*p, CHAR_WHITESPACE))
+          p ++;
+        if (end - p < 2 || p[0] != '-' || p[1] != '-')
+          return p - begin;
+        [[fallthrough]];
+
+      // Comment, subtraction operator or negative number
+      case '-':
+        if (end - p >= 2 && p[0] == '-' && p[1] == '-')
         {
-          report<SyntaxError>(location, fmt::format("Invalid character '{}'", line.substr(location.col(), 1)));
-          return token_list_type({});
+          p += 2;
+          while (p < end && is_class(*p, CHAR_WHITESPACE))
+            p ++;
+          tokens.push_back(Token(TokenKind::COMMENT, string_view_t(p, end - p), location));
+          return end - begin;
         }
-
-        // if there is more than one matched token, then sort the current matched tokens
-        if (matched_tokens.size() > 1)
+        if (end - p >= 2 && is_class(p[1], CHAR_DIGIT))
+          break;
+        return token(TokenKind::OPERATOR_SUBTRACT, 1);
+
+      // Delimiters
+      case '(': return token(TokenKind::PARENTHESIS_LEFT, 1);
+      case ')': return token(TokenKind::PARENTHESIS_RIGHT, 1);
+      case '[': return token(TokenKind::SQUARE_BRACKET_LEFT, 1);
+      case ']': return token(TokenKind::SQUARE_BRACKET_RIGHT, 1);
+      case '{': return token(TokenKind::CURLY_BRACKET_LEFT, 1);
+      case '}': return token(TokenKind::CURLY_BRACKET_RIGHT, 1);
+
+      // Symbols
+      case ':': return token(TokenKind::SYMBOL_COLON, 1);
+      case ',': return token(TokenKind::SYMBOL_COMMA, 1);
+      case '\\': return token(TokenKind::SYMBOL_BACKSLASH, 1);
+      case '.':
+        if (end - p >= 2 && p[1] == '.')
+          return token(TokenKind::OPERATOR_RANGE, 2);
+        return token(TokenKind::SYMBOL_DOT, 1);
+
+      // Operators
+      case '?': return token(TokenKind::OPERATOR_MAYBE, 1);
+      case '&': return token(TokenKind::OPERATOR_INTERSECTION, 1);
+      case '|': return token(TokenKind::OPERATOR_UNION, 1);
+      case '#': return token(TokenKind::OPERATOR_LENGTH, 1);
+      case '$': return token(TokenKind::OPERATOR_STRING, 1);
+      case '*': return token(TokenKind::OPERATOR_MULTIPLY, 1);
+      case '%': return token(TokenKind::OPERATOR_REMAINDER, 1);
+      case '+': return token(TokenKind::OPERATOR_ADD, 1);
+      case '<':
+        if (end - p >= 3 && p[1] == '=' && p[2] == '>')
+          return token(TokenKind::OPERATOR_COMPARE, 3);
+        if (end - p >= 2 && p[1] == '=')
+          return token(TokenKind::OPERATOR_LESS_EQUAL, 2);
+        return token(TokenKind::OPERATOR_LESS, 1);
+      case '>':
+        if (end - p >= 2 && p[1] == '=')
+          return token(TokenKind::OPERATOR_GREATER_EQUAL, 2);
+        return token(TokenKind::OPERATOR_GREATER, 1);
+      case '=':
+        if (end - p >= 3 && p[1] == '=' && p[2] == '=')
+          return token(TokenKind::OPERATOR_IDENTICAL, 3);
+        if (end - p >= 2 && p[1] == '=')
+          return token(TokenKind::OPERATOR_EQUAL, 2);
+        if (end - p >= 2 && p[1] == '~')
+          return token(TokenKind::OPERATOR_MATCH, 2);
+        return token(TokenKind::OPERATOR_ASSIGN, 1);
+      case '!':
+        if (end - p >= 3 && p[1] == '=' && p[2] == '=')
+          return token(TokenKind::OPERATOR_NOT_IDENTICAL, 3);
+        if (end - p >= 2 && p[1] == '=')
+          return token(TokenKind::OPERATOR_NOT_EQUAL, 2);
+        if (end - p >= 2 && p[1] == '~')
+          return token(TokenKind::OPERATOR_NOT_MATCH, 2);
+        return 0;
+      case '~': return token(TokenKind::OPERATOR_CAPTURE, 1);
+
+      // Regex literal, or division or quotient operator
+      case '/':
+      {
+        auto q = scan_delimited(p + 1, end, '/');
+        if (q != nullptr)
         {
-          std::sort(matched_tokens.begin(), matched_tokens.end(), [](std::tuple<Token, size_t>& a, std::tuple<Token, size_t>& b)->bool {
-            return std::get<0>(a) < std::get<0>(b) || std::get<1>(a) > std::get<1>(b);
-          });
+          while (q < end && is_class(*q, CHAR_LETTER))
+            q ++;
+
+          // An empty regex literal without flags has the same length as the quotient operator, which comes first
+          if (q - p > 2)
+          {
+            tokens.push_back(Token(TokenKind::LITERAL_REGEX, string_view_t(p, q - p), location));
+            return q - p;
+          }
         }
+        if (end - p >= 2 && p[1] == '/')
+          return token(TokenKind::OPERATOR_QUOTIENT, 2);
+        return token(TokenKind::OPERATOR_DIVIDE, 1);
+      }
+
+      // Stropped identifier, which can't be empty
+      case '`':
+      {
+        auto q = scan_delimited(p + 1, end, '`');
+        if (q == nullptr || q - p == 2)
+          return 0;
+        tokens.push_back(Token(TokenKind::IDENTIFIER, string_view_t(p + 1, q - p - 2), location));
+        return q - p;
+      }
 
-        // Add the first token and increase the position to past the token
-        auto token = *matched_tokens.begin();
-        tokens.push_back(std::get<0>(token));
-        location.increase_col_(std::get<1>(token));
+      // Rune literal
+      case '\'':
+      {
+        auto q = scan_delimited(p + 1, end, '\'');
+        if (q == nullptr)
+          return 0;
+        tokens.push_back(Token(TokenKind::LITERAL_RUNE, string_view_t(p + 1, q - p - 2), location));
+        return q - p;
       }
 
-      // Add a newline at the end of the line and update the location to the next line
-      tokens.push_back(Token(TokenKind::NEWLINE, location));
-      location.increase_line_();
+      // String literal
+      case '"':
+      {
+        auto q = scan_delimited(p + 1, end, '"');
+        if (q == nullptr)
+          return 0;
+        tokens.push_back(Token(TokenKind::LITERAL_STRING, string_view_t(p + 1, q - p - 2), location));
+        return q - p;
+      }
+
+      default:
+        break;
+    }
+
+    // Identifier or keyword
+    if (is_class(*p, CHAR_IDENTIFIER_START))
+    {
+      auto q = p + 1;
+      while (q < end && is_class(*q, CHAR_IDENTIFIER))
+        q ++;
+
+      // Keywords only match if the identifier is not longer than the keyword
+      auto kind = keyword_kind(p, q - p);
+      if (kind == TokenKind::IDENTIFIER)
+        tokens.push_back(Token(kind, string_view_t(p, q - p), location));
+      else
+        tokens.push_back(Token(kind, location));
+      return q - p;
     }
 
-    // Add dedent tokens for the remaining indents
-    while (indents.back() > 0)
+    // Int or float literal
+    if (is_class(*p, CHAR_DIGIT) || *p == '-')
     {
-      indents.pop_back();
-      tokens.push_back(Token(TokenKind::DEDENT, location));
+      bool is_float;
+      auto q = scan_number(p, end, is_float);
+      tokens.push_back(Token(is_float ? TokenKind::LITERAL_FLOAT : TokenKind::LITERAL_INT, string_view_t(p, q - p), location));
+      return q - p;
     }
 
-    // Add an end token
-    tokens.push_back(Token(TokenKind::END, location));
+    // No token matched
+    return 0;
+  }
 
-    // Return the tokens
-    return tokens;
+  // Scan the end of a delimited literal and return past its closing delimiter, or nullptr if it is not closed
+  const char* Lexer::scan_delimited(const char* p, const char* end, char delimiter)
+  {
+    while (p < end && *p != delimiter)
+    {
+      // A backslash escapes the next character
+      if (*p == '\\')
+      {
+        if (end - p < 2)
+          return nullptr;
+        p += 2;
+      }
+      else
+        p ++;
+    }
+    return p < end ? p + 1 : nullptr;
+  }
+
+  // Scan an int or float literal and return past its end
+  const char* Lexer::scan_number(const char* p, const char* end, bool& is_float)
+  {
+    is_float = false;
+
+    // Check for a hexadecimal int literal, which can't be negative
+    if (end - p >= 3 && p[0] == '0' && (p[1] == 'X' || p[1] == 'x') && is_class(p[2], CHAR_HEX_DIGIT))
+    {
+      p += 3;
+      while (p < end && (is_class(*p, CHAR_HEX_DIGIT) || *p == '_'))
+        p ++;
+      return p;
+    }
+
+    // Scan the integral part
+    if (*p == '-')
+      p ++;
+    if (*p == '0')
+      p ++;
+    else
+    {
+      p ++;
+      while (p < end && (is_class(*p, CHAR_DIGIT) || *p == '_'))
+        p ++;
+    }
+
+    // Scan the fractional part
+    if (end - p >= 2 && p[0] == '.' && is_class(p[1], CHAR_DIGIT))
+    {
+      is_float = true;
+      p += 2;
+      while (p < end && (is_class(*p, CHAR_DIGIT) || *p == '_'))
+        p ++;
+    }
+
+    // Scan the exponent, which is optional after a fractional part
+    if (p < end && (*p == 'E' || *p == 'e'))
+    {
+      auto q = p + 1;
+      if (q < end && (*q == '+' || *q == '-'))
+        q ++;
+      if (q < end && *q == '0')
+      {
+        is_float = true;
+        p = q + 1;
+      }
+      else if (q < end && is_class(*q, CHAR_DIGIT))
+      {
+        is_float = true;
+        p = q + 1;
+        while (p < end && (is_class(*p, CHAR_DIGIT) || *p == '_'))
+          p ++;
+      }
+    }
+
+    return p;
+  }
+
+  // Scan a token at the location in the line using the regex rules, and return its length or zero if no token matched
+  size_t Lexer::match_token(string_view_t line, Location& location, token_list_type& tokens)
+  {
+    // The source is validated when it is loaded, so the encoding of the line is not checked again for every match
+    auto flags = static_cast<utils::RegexMatchFlags>(utils::REGEX_MATCH_AT_BEGIN | utils::REGEX_MATCH_NO_UTF_CHECK);
+
+    // Check for comments at the current position
+    size_t offsets[4];
+    if (comment_pattern_.match(line, offsets, 2, location.col(), flags) > 0 && offsets[2] != PCRE2_UNSET)
+    {
+      tokens.push_back(Token(TokenKind::COMMENT, line.substr(offsets[2], offsets[3] - offsets[2]), location));
+      return offsets[1] - offsets[0];
+    }
+
+    // Check for whitespaces at the current position
+    if (whitespace_pattern_.match(line, offsets, 1, location.col(), flags) > 0)
+      return offsets[1] - offsets[0];
+
+    // Iterate over the rules to see if they match
+    std::vector<std::tuple<Token, size_t>> matched_tokens;
+    for (auto& rule : rules_)
+    {
+      if (rule.pattern().match(line, offsets, 2, location.col(), flags) > 0)
+        matched_tokens.push_back(std::make_tuple(Token(rule.kind(), rule.replace(line, offsets), location), offsets[1] - offsets[0]));
+    }
+
+    // If there are no matched tokens, then no token matched
+    if (matched_tokens.empty())
+      return 0;
+
+    // if there is more than one matched token, then sort the current matched tokens
+    if (matched_tokens.size() > 1)
+    {
+      std::sort(matched_tokens.begin(), matched_tokens.end(), [](std::tuple<Token, size_t>& a, std::tuple<Token, size_t>& b)->bool {
+        return std::get<0>(a) < std::get<0>(b) || std::get<1>(a) > std::get<1>(b);
+      });
+    }
+
+    // Add the first token and return its length
+    auto token = *matched_tokens.begin();
+    tokens.push_back(std::get<0>(token));
+    return std::get<1>(token);
   }
 }
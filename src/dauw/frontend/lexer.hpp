@@ -8,12 +8,55 @@
 #include <dauw/utils/regex.hpp>
 
 #include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
+#include <thread>
 #include <tuple>
 
 
+// Defines for the parallel lexer
+#ifndef DAUW_LEXER_PARALLEL_MIN_SIZE
+  #define DAUW_LEXER_PARALLEL_MIN_SIZE (1024 * 1024)
+#endif
+
+#ifndef DAUW_LEXER_CHUNKS_PER_THREAD
+  #define DAUW_LEXER_CHUNKS_PER_THREAD 4
+#endif
+
+#ifndef DAUW_LEXER_MAX_CHUNK_SIZE
+  #define DAUW_LEXER_MAX_CHUNK_SIZE (256 * 1024)
+#endif
+
+#ifndef DAUW_LEXER_CHUNKS_AHEAD_PER_THREAD
+  #define DAUW_LEXER_CHUNKS_AHEAD_PER_THREAD 2
+#endif
+
+
 namespace dauw
 {
+  // Enum that defines the mode in which the lexer scans tokens
+  enum class LexerMode : uint8_t
+  {
+    SCANNER,  // Scan tokens using the hand-written maximal munch scanner
+    REGEX,    // Scan tokens by trying all regex rules, used as a reference for the scanner
+  };
+
+
+  // Enum that defines the character classes for the scanner
+  enum LexerCharClass : uint8_t
+  {
+    CHAR_NONE             = 0,
+    CHAR_WHITESPACE       = 1 << 0,   // ' ' and '\t'
+    CHAR_DIGIT            = 1 << 1,   // '0' to '9'
+    CHAR_HEX_DIGIT        = 1 << 2,   // '0' to '9', 'A' to 'F' and 'a' to 'f'
+    CHAR_LETTER           = 1 << 3,   // 'A' to 'Z' and 'a' to 'z'
+    CHAR_IDENTIFIER_START = 1 << 4,   // Letters and '_'
+    CHAR_IDENTIFIER       = 1 << 5,   // Letters, digits and '_'
+  };
+
+
   // Class that defines a rule for the lexer
   class LexerRule
   {
@@ -37,10 +80,55 @@ namespace dauw
       TokenKind kind();
 
       // Return the regular expression pattern of the rule
-      utils::Regex pattern();
+      utils::Regex& pattern();
 
-      // Return the replacement of the rule based on a match
-      string_t replace(utils::RegexMatch match);
+      // Return the replacement of the rule based on the group offsets of a match in a line
+      string_t replace(string_view_t line, size_t* offsets);
+  };
+
+
+  // Structure that defines a chunk of lines of the source that is scanned in parallel
+  struct LexerChunk
+  {
+    // The tokens of the chunk, which are handed to the parser once the chunk is scanned
+    std::deque<Token> tokens;
+
+    // Indicator if the chunk has been scanned
+    bool scanned;
+
+    // Indicator if the chunk contains a syntax error
+    bool failed;
+  };
+
+
+  // Structure that defines the state of a parallel scan, which is shared between the lexer and the scanning threads
+  struct LexerParallelScan
+  {
+    // The lines at which the source is split into chunks, including the end line
+    std::vector<size_t> lines;
+
+    // The chunks of the source in source order
+    std::vector<LexerChunk> chunks;
+
+    // The index of the next chunk that is scanned by a thread
+    size_t next_scanned;
+
+    // The index of the next chunk that is handed to the parser
+    size_t next_handed;
+
+    // The number of chunks that may be scanned ahead of the chunk that is handed to the parser next
+    size_t chunks_ahead;
+
+    // Indicator if the threads should stop scanning
+    bool stopped;
+
+    // The mutex that guards the state, and the conditions that signal a scanned and a handed chunk
+    std::mutex mutex;
+    std::condition_variable chunk_scanned;
+    std::condition_variable chunk_handed;
+
+    // The threads that scan the chunks
+    std::vector<std::thread> threads;
   };
 
 
@@ -68,16 +156,95 @@ namespace dauw
       // Rules for the lexer
       static std::vector<LexerRule> rules_;
 
+      // Character classes for the scanner
+      static const std::array<uint8_t, 256> char_classes_;
+
 
       // The source of the lexer
       source_ptr source_;
 
+      // The mode in which the lexer scans tokens
+      LexerMode mode_;
+
+      // The location in the source at which the lexer continues scanning
+      Location location_;
+
+      // The line of the source that is currently scanned
+      string_view_t line_;
+
+      // The stack of indentation levels
+      std::deque<int> indents_;
+
+      // The tokens that have been scanned, but not returned yet
+      token_list_type pending_;
+
+      // Indicator if the lexer is at the start of a line
+      bool at_line_start_;
+
+      // Indicator if the lexer reached the end of the source
+      bool at_end_;
+
+      // The line at which the lexer stops scanning
+      size_t end_line_;
+
+      // The number of threads that scan the source in parallel before the first token
+      size_t thread_count_;
+
+      // The state of the parallel scan, or nullptr if the source is scanned sequentially
+      std::unique_ptr<LexerParallelScan> parallel_;
+
+
+      // Return if a character belongs to the specified character class
+      static inline bool is_class(char c, LexerCharClass char_class) { return (char_classes_[static_cast<uint8_t>(c)] & char_class) != 0; }
+
+      // Return the kind of a keyword, or an identifier if the name is not a keyword
+      static TokenKind keyword_kind(const char* name, size_t length);
+
+      // Scan a token at the location in the line using the scanner, and return its length or zero if no token matched
+      size_t scan_token(string_view_t line, Location& location, token_list_type& tokens);
+
+      // Scan the end of a delimited literal and return past its closing delimiter, or nullptr if it is not closed
+      static const char* scan_delimited(const char* p, const char* end, char delimiter);
+
+      // Scan an int or float literal and return past its end
+      static const char* scan_number(const char* p, const char* end, bool& is_float);
+
+      // Scan a token at the location in the line using the regex rules, and return its length or zero if no token matched
+      size_t match_token(string_view_t line, Location& location, token_list_type& tokens);
+
+      // Scan the next step of the source and add the resulting tokens to the pending tokens
+      void scan_next_();
+
+      // Start scanning chunks of the source on multiple threads ahead of the parser
+      void scan_parallel_();
+
+      // Wait for the next chunk of the parallel scan and add its stitched tokens to the pending tokens
+      void hand_chunk_();
+
+      // Stop the threads of the parallel scan and continue scanning sequentially
+      void stop_parallel_();
+
+      // Return the lines at which the source is split into at most the specified number of chunks, including the end line
+      std::vector<size_t> split_lines_(size_t chunk_count);
+
+      // Constructor for a lexer that scans a chunk of lines of the source
+      Lexer(Reporter* reporter, source_ptr source, LexerMode mode, size_t begin_line, size_t end_line);
+
 
     public:
       // Constructor
-      Lexer(Reporter* reporter, source_ptr source);
+      Lexer(Reporter* reporter, source_ptr source, LexerMode mode = LexerMode::SCANNER);
+
+      // Destructor
+      ~Lexer();
+
+      // Set the number of threads that scan the source in parallel before the first token, where 1 disables parallel scanning
+      void set_thread_count(size_t thread_count);
+
+      // Return the next token of the source, scanning as much of the source as needed to produce it
+      Token next_token();
 
-      // Convert a string into a token iterator
+      // Convert the source into a deque of tokens at once
       token_list_type tokenize();
   };
 }
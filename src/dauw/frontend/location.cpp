@@ -4,7 +4,7 @@ namespace dauw
 {
   // Constructor for a location
   Location::Location(size_t line, size_t col)
-    : line_(line), col_(col)
+    : line_(static_cast<uint32_t>(line)), col_(static_cast<uint32_t>(col))
   {
   }
 
@@ -15,13 +15,13 @@ namespace dauw
   }
 
   // Return the line of the location
-  size_t& Location::line()
+  uint32_t& Location::line()
   {
     return line_;
   }
 
   // Return the column of the location
-  size_t& Location::col()
+  uint32_t& Location::col()
   {
     return col_;
   }
@@ -29,14 +29,14 @@ namespace dauw
   // Increase the line of the location
   void Location::increase_line_(size_t n)
   {
-    line_ += n;
+    line_ += static_cast<uint32_t>(n);
     col_ = 0;
   }
 
   // Increase the column of the location
   void Location::increase_col_(size_t n)
   {
-    col_ += n;
+    col_ += static_cast<uint32_t>(n);
   }
 
   // Return if the location equals another location
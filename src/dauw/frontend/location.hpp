@@ -13,10 +13,10 @@ namespace dauw
   {
     private:
       // The line of the location
-      size_t line_;
+      uint32_t line_;
 
       // The column of the location
-      size_t col_;
+      uint32_t col_;
 
 
       // Increase the line of the location
@@ -32,10 +32,10 @@ namespace dauw
       Location();
 
       // Return the line of the location
-      size_t& line();
+      uint32_t& line();
 
       // Return the column of the location
-      size_t& col();
+      uint32_t& col();
 
       // Operator overloads
       bool operator==(const Location& other);
@@ -2,19 +2,51 @@
 
 namespace dauw
 {
+  // Infix rules for the parser indexed by token kind
+  const std::array<ParserInfixRule, 256> Parser::infix_rules_ = []() {
+    std::array<ParserInfixRule, 256> rules = {};
+    auto rule = [&rules](TokenKind kind, ParserPrecedence precedence, bool chains) {
+      rules[static_cast<uint8_t>(kind)] = ParserInfixRule{precedence, chains};
+    };
+
+    rule(TokenKind::OPERATOR_LOGIC_OR, ParserPrecedence::LOGIC_OR, true);
+    rule(TokenKind::OPERATOR_LOGIC_AND, ParserPrecedence::LOGIC_AND, true);
+    rule(TokenKind::OPERATOR_EQUAL, ParserPrecedence::EQUALITY, false);
+    rule(TokenKind::OPERATOR_NOT_EQUAL, ParserPrecedence::EQUALITY, false);
+    rule(TokenKind::OPERATOR_IDENTICAL, ParserPrecedence::EQUALITY, false);
+    rule(TokenKind::OPERATOR_NOT_IDENTICAL, ParserPrecedence::EQUALITY, false);
+    rule(TokenKind::OPERATOR_LESS, ParserPrecedence::COMPARISON, false);
+    rule(TokenKind::OPERATOR_LESS_EQUAL, ParserPrecedence::COMPARISON, false);
+    rule(TokenKind::OPERATOR_GREATER, ParserPrecedence::COMPARISON, false);
+    rule(TokenKind::OPERATOR_GREATER_EQUAL, ParserPrecedence::COMPARISON, false);
+    rule(TokenKind::OPERATOR_MATCH, ParserPrecedence::COMPARISON, false);
+    rule(TokenKind::OPERATOR_NOT_MATCH, ParserPrecedence::COMPARISON, false);
+    rule(TokenKind::OPERATOR_CAPTURE, ParserPrecedence::COMPARISON, false);
+    rule(TokenKind::OPERATOR_COMPARE, ParserPrecedence::THREEWAY, false);
+    rule(TokenKind::OPERATOR_RANGE, ParserPrecedence::RANGE, false);
+    rule(TokenKind::OPERATOR_ADD, ParserPrecedence::TERM, true);
+    rule(TokenKind::OPERATOR_SUBTRACT, ParserPrecedence::TERM, true);
+    rule(TokenKind::OPERATOR_MULTIPLY, ParserPrecedence::FACTOR, true);
+    rule(TokenKind::OPERATOR_DIVIDE, ParserPrecedence::FACTOR, true);
+    rule(TokenKind::OPERATOR_QUOTIENT, ParserPrecedence::FACTOR, true);
+    rule(TokenKind::OPERATOR_REMAINDER, ParserPrecedence::FACTOR, true);
+    return rules;
+  }();
+
+
   // Constructor for the parser
-  Parser::Parser(Reporter* reporter, Lexer::token_list_type tokens)
-    : ReporterAware(reporter), tokens_(tokens)
+  Parser::Parser(Reporter* reporter, Arena* arena, Lexer* lexer)
+    : ReporterAware(reporter), arena_(arena), lexer_(lexer), current_(TokenKind::END, Location()), next_(TokenKind::END, Location())
   {
-    index_ = 0;
   }
 
-  // Parse a deque of tokens into an expression
+  // Parse the tokens of the lexer into an expression
   expr_ptr Parser::parse()
   {
     // Parse the script
     try
     {
+      next_ = lexer_->next_token();
       return parse_script();
     }
     catch (SyntaxError& ex)
@@ -28,15 +60,15 @@ namespace dauw
   // --------------------------------------------------------------------------
 
   // Return the current token
-  Token Parser::current()
+  Token& Parser::current()
   {
-    return tokens_[index_ - 1];
+    return current_;
   }
 
   // Return the token past the current token
-  Token Parser::next()
+  Token& Parser::next()
   {
-    return tokens_[index_];
+    return next_;
   }
 
   // Return if the parser reached the end of the tokens
@@ -46,10 +78,14 @@ namespace dauw
   }
 
   // Advance to the next token and return that token
-  Token Parser::advance()
+  Token& Parser::advance()
   {
     if (!at_end())
-      index_ ++;
+    {
+      auto token = lexer_->next_token();
+      current_ = std::move(next_);
+      next_ = std::move(token);
+    }
     return current();
   }
 
@@ -113,60 +149,6 @@ namespace dauw
     }
   }
 
-  // --------------------------------------------------------------------------
-  // PARSER HELPER FUNCTIONS
-  // --------------------------------------------------------------------------
-
-  // Parse an infix operation
-  expr_ptr Parser::parse_infix_op(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand)
-  {
-    auto left = parse_operand(this);
-    while (match(op_kinds))
-    {
-      auto op = current();
-      auto right = parse_operand(this);
-      left = std::make_shared<ExprBinary>(left, op, right);
-    }
-    return left;
-  }
-
-  // Parse an infix operation that is not allowed to chain
-  expr_ptr Parser::parse_infix_op_single(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand)
-  {
-    auto left = parse_operand(this);
-    if (match(op_kinds))
-    {
-      auto op = current();
-      auto right = parse_operand(this);
-      return std::make_shared<ExprBinary>(left, op, right);
-    }
-    return left;
-  }
-
-  // Parse a prefix operation
-  expr_ptr Parser::parse_prefix_op(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand)
-  {
-    if (match(op_kinds))
-    {
-      auto op = current();
-      auto right = parse_prefix_op(op_kinds, parse_operand);
-      return std::make_shared<ExprUnary>(op, right);
-    }
-    return parse_operand(this);
-  }
-
-  // Parse a prefix operation that is not allowed to chain
-  expr_ptr Parser::parse_prefix_op_single(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand)
-  {
-    if (match(op_kinds))
-    {
-      auto op = current();
-      auto right = parse_operand(this);
-      return std::make_shared<ExprUnary>(op, right);
-    }
-    return parse_operand(this);
-  }
-
   // --------------------------------------------------------------------------
   // PARSERS FOR EXPRESSIONS
   // --------------------------------------------------------------------------
@@ -183,7 +165,7 @@ namespace dauw
       exprs.push_back(parse_line());
 
     // Return a block expresssion containing the expressions
-    return std::make_shared<ExprBlock>(exprs);
+    return arena_->make<ExprBlock>(exprs);
   }
 
   // Parse a line
@@ -240,9 +222,6 @@ namespace dauw
   // def → 'def' IDENTIFIER ('(' parameters ')')? (':' type)? '=' assignment
   expr_ptr Parser::parse_def()
   {
-    // Set the keyword
-    auto keyword = current();
-
     // Parse the identifier
     auto name = consume(TokenKind::IDENTIFIER, "in def declaration");
 
@@ -268,8 +247,8 @@ namespace dauw
 
       // Return the declaration
       // TODO: Add the proper function type
-      auto function = std::make_shared<ExprFunction>(token, parameters, return_type, body);
-      return std::make_shared<ExprDef>(name, std::nullopt, function);
+      auto function = arena_->make<ExprFunction>(token, parameters, return_type, body);
+      return arena_->make<ExprDef>(name, std::nullopt, function);
     }
     else
     {
@@ -285,7 +264,7 @@ namespace dauw
       auto value = parse_assignment();
 
       // Return the declaration
-      return std::make_shared<ExprDef>(name, type, value);
+      return arena_->make<ExprDef>(name, type, value);
     }
   }
 
@@ -342,7 +321,7 @@ namespace dauw
     auto expr = parse_operation();
 
     // Return the expression
-    return std::make_shared<ExprEcho>(keyword, expr);
+    return arena_->make<ExprEcho>(keyword, expr);
   }
 
   // Parse an if expression
@@ -365,7 +344,7 @@ namespace dauw
       false_branch = std::make_optional(parse_expression());
 
     // Return the expression
-    return std::make_shared<ExprIf>(keyword, condition, true_branch, false_branch);
+    return arena_->make<ExprIf>(keyword, condition, true_branch, false_branch);
   }
 
   // Parse a for expression
@@ -387,7 +366,7 @@ namespace dauw
     auto body = parse_expression();
 
     // Return the expression
-    return std::make_shared<ExprFor>(keyword, name, iterable, body);
+    return arena_->make<ExprFor>(keyword, name, iterable, body);
   }
 
   // Parse a while expression
@@ -405,7 +384,7 @@ namespace dauw
     auto body = parse_expression();
 
     // Return the expression
-    return std::make_shared<ExprWhile>(keyword, condition, body);
+    return arena_->make<ExprWhile>(keyword, condition, body);
   }
 
   // Parse an until expression
@@ -423,7 +402,7 @@ namespace dauw
     auto body = parse_expression();
 
     // Return the expression
-    return std::make_shared<ExprUntil>(keyword, condition, body);
+    return arena_->make<ExprUntil>(keyword, condition, body);
   }
 
   // Parse a block expression
@@ -444,114 +423,72 @@ namespace dauw
     } while (!match(TokenKind::DEDENT));
 
     // Return a block expresssion containing the expressions
-    return std::make_shared<ExprBlock>(exprs);
+    return arena_->make<ExprBlock>(exprs);
   }
 
   // Parse an operation expression
   // operation → logic_or
-  expr_ptr Parser::parse_operation()
-  {
-    return parse_logic_or();
-  }
-
-  // Parse a logic or expression
   // logic_or → logic_and ('or' logic_and)*
-  expr_ptr Parser::parse_logic_or()
-  {
-    return parse_infix_op({
-      TokenKind::OPERATOR_LOGIC_OR,
-    }, &Parser::parse_logic_and);
-  }
-
-  // Parse a logic and expression
   // logic_and → logic_not ('and' logic_not)*
-  expr_ptr Parser::parse_logic_and()
-  {
-    return parse_infix_op({
-      TokenKind::OPERATOR_LOGIC_AND,
-    }, &Parser::parse_logic_not);
-  }
-
-  // Parse a logic not expression
   // logic_not → 'not' logic_not | equality
-  expr_ptr Parser::parse_logic_not()
-  {
-    return parse_prefix_op({
-      TokenKind::OPERATOR_LOGIC_NOT,
-    }, &Parser::parse_equality);
-  }
-
-  // Parse an equality expression
   // equality → comparison (('==' | '!=' | '===' | '!==') comparison)?
-  expr_ptr Parser::parse_equality()
+  // comparison → threeway (('<' | '<=' | '>' | '>=' | '=~' | '!~' | '~') threeway)?
+  // threeway → range ('<=>' range)?
+  // range → term ('..' term)?
+  // term → factor (('+' | '-') factor)*
+  // factor → unary (('*' | '/' | '//' | '%') unary)*
+  // unary → ('-' | '#' | '$') unary | primary
+  expr_ptr Parser::parse_operation()
   {
-    return parse_infix_op_single({
-      TokenKind::OPERATOR_EQUAL,
-      TokenKind::OPERATOR_NOT_EQUAL,
-      TokenKind::OPERATOR_IDENTICAL,
-      TokenKind::OPERATOR_NOT_IDENTICAL,
-    }, &Parser::parse_comparison);
+    return parse_precedence(ParserPrecedence::LOGIC_OR);
   }
 
-  // Parse a comparison expression
-  // comparison → threeway (('<' | '<=' | '>' | '>=' | '=~' | '!~') threeway)?
-  expr_ptr Parser::parse_comparison()
+  // Parse an operation expression of which the infix operators bind at least as tight as the specified precedence
+  expr_ptr Parser::parse_precedence(ParserPrecedence precedence)
   {
-    return parse_infix_op_single({
-      TokenKind::OPERATOR_LESS,
-      TokenKind::OPERATOR_LESS_EQUAL,
-      TokenKind::OPERATOR_GREATER,
-      TokenKind::OPERATOR_GREATER_EQUAL,
-      TokenKind::OPERATOR_MATCH,
-      TokenKind::OPERATOR_NOT_MATCH,
-    }, &Parser::parse_threeway);
-  }
+    expr_ptr left;
 
-  // Parse a threeway expression
-  // threeway → range ('<=>' range)?
-  expr_ptr Parser::parse_threeway()
-  {
-    return parse_infix_op_single({
-      TokenKind::OPERATOR_COMPARE,
-    }, &Parser::parse_range);
-  }
+    // The precedence that the following infix operators must bind looser than
+    auto ceiling = ParserPrecedence::UNARY;
 
-  // Parse a range expression
-  // range → term ('..' term)?
-  expr_ptr Parser::parse_range()
-  {
-    return parse_infix_op_single({
-      TokenKind::OPERATOR_RANGE,
-    }, &Parser::parse_term);
-  }
+    // Check for a logic not operation, which is only allowed where a logic not expression is expected and can only be followed by looser operators
+    if (precedence <= ParserPrecedence::LOGIC_NOT && match(TokenKind::OPERATOR_LOGIC_NOT))
+    {
+      auto op = current();
+      auto right = parse_precedence(ParserPrecedence::LOGIC_NOT);
+      left = arena_->make<ExprUnary>(op, right);
+      ceiling = ParserPrecedence::LOGIC_NOT;
+    }
 
-  // Parse a term expression
-  // term → factor (('+' | '-') factor)*
-  expr_ptr Parser::parse_term()
-  {
-    return parse_infix_op({
-      TokenKind::OPERATOR_ADD,
-      TokenKind::OPERATOR_SUBTRACT,
-    }, &Parser::parse_factor);
-  }
+    // Check for an unary operation
+    else if (match({TokenKind::OPERATOR_SUBTRACT, TokenKind::OPERATOR_LENGTH, TokenKind::OPERATOR_STRING}))
+    {
+      auto op = current();
+      auto right = parse_precedence(ParserPrecedence::UNARY);
+      left = arena_->make<ExprUnary>(op, right);
+    }
 
-  // Parse a factor expression
-  // factor → unary (('*' | '/' | '//' | '%') unary)*
-  expr_ptr Parser::parse_factor()
-  {
-    return parse_infix_op({
-      TokenKind::OPERATOR_MULTIPLY,
-      TokenKind::OPERATOR_DIVIDE,
-      TokenKind::OPERATOR_QUOTIENT,
-      TokenKind::OPERATOR_REMAINDER,
-    }, &Parser::parse_unary);
-  }
+    // Otherwise parse a primary expression
+    else
+      left = parse_primary();
 
-  // Parse an unary expression
-  // unary → ('-' | '#' | '$') unary | primary
-  expr_ptr Parser::parse_unary()
-  {
-    return parse_prefix_op({TokenKind::OPERATOR_SUBTRACT, TokenKind::OPERATOR_LENGTH, TokenKind::OPERATOR_STRING}, &Parser::parse_primary);
+    // Loop over the infix operators, where tokens that are not infix operators have no precedence and end the loop
+    while (true)
+    {
+      auto rule = infix_rules_[static_cast<uint8_t>(next().kind())];
+      if (rule.precedence < precedence || rule.precedence >= ceiling)
+        break;
+
+      auto op = advance();
+      auto operand_precedence = static_cast<ParserPrecedence>(static_cast<uint8_t>(rule.precedence) + 1);
+      auto right = parse_precedence(operand_precedence);
+      left = arena_->make<ExprBinary>(left, op, right);
+
+      // Operators that don't chain can only be followed by looser operators
+      ceiling = rule.chains ? operand_precedence : rule.precedence;
+    }
+
+    return left;
   }
 
   // Parse a primary expression
@@ -571,10 +508,10 @@ namespace dauw
         auto token = current();
 
         // Parse the arguments
-        auto arguments = std::make_shared<ExprSequence>(token, parse_arguments());
+        auto arguments = arena_->make<ExprSequence>(token, parse_arguments());
 
         // Create the call expression
-        expr = std::make_shared<ExprCall>(expr, token, arguments);
+        expr = arena_->make<ExprCall>(expr, token, arguments);
       }
 
       // Check for a get postfix
@@ -584,7 +521,7 @@ namespace dauw
         auto name = consume(TokenKind::IDENTIFIER, "in get expression");
 
         // Return the expression
-        expr = std::make_shared<ExprGet>(expr, name);
+        expr = arena_->make<ExprGet>(expr, name);
       }
 
       // Otherwise break the loop
@@ -604,11 +541,11 @@ namespace dauw
   {
     // Check for a literal expression
     if (match(TokenKind::KEYWORD_NOTHING))
-      return std::make_shared<ExprLiteral>(Value::value_nothing, current().location());
+      return arena_->make<ExprLiteral>(Value::value_nothing, current().location());
     if (match(TokenKind::KEYWORD_FALSE))
-      return std::make_shared<ExprLiteral>(Value::value_false, current().location());
+      return arena_->make<ExprLiteral>(Value::value_false, current().location());
     if (match(TokenKind::KEYWORD_TRUE))
-      return std::make_shared<ExprLiteral>(Value::value_true, current().location());
+      return arena_->make<ExprLiteral>(Value::value_true, current().location());
     if (match(TokenKind::LITERAL_INT))
       return parse_int();
     if (match(TokenKind::LITERAL_FLOAT))
@@ -622,7 +559,7 @@ namespace dauw
 
     // Check for a name expression
     if (match(TokenKind::IDENTIFIER))
-      return std::make_shared<ExprName>(current());
+      return arena_->make<ExprName>(current());
 
     // Check for a sequence expression
     if (match(TokenKind::SQUARE_BRACKET_LEFT))
@@ -651,7 +588,7 @@ namespace dauw
     {
       auto int_value = utils::parse_int(current().value());
       auto value = Value::of_int(int_value);
-      return std::make_shared<ExprLiteral>(value, current().location());
+      return arena_->make<ExprLiteral>(value, current().location());
     }
     catch (ValueMismatchException& ex)
     {
@@ -672,7 +609,7 @@ namespace dauw
     {
       auto float_value = utils::parse_float(current().value());
       auto value = Value::of_float(float_value);
-      return std::make_shared<ExprLiteral>(value, current().location());
+      return arena_->make<ExprLiteral>(value, current().location());
     }
     catch (ValueMismatchException& ex)
     {
@@ -691,7 +628,7 @@ namespace dauw
     {
       auto rune_value = utils::parse_rune(current().value());
       auto value = Value::of_rune(rune_value);
-      return std::make_shared<ExprLiteral>(value, current().location());
+      return arena_->make<ExprLiteral>(value, current().location());
     }
     catch (ValueMismatchException& ex)
     {
@@ -712,12 +649,12 @@ namespace dauw
     {
       auto string_value = utils::parse_string(current().value());
       // TODO: Pointer leak
-      auto value = Value::of_obj(new ObjString(string_value));
-      return std::make_shared<ExprLiteral>(value, current().location());
+      auto value = Value::of_obj(new ObjString(string_value.c_str()));
+      return arena_->make<ExprLiteral>(value, current().location());
     }
-    catch (...)
+    catch (std::invalid_argument& ex)
     {
-      // TODO: Add proper catch
+      report<SyntaxError>(current().location(), ex.what());
       return nullptr;
     }
   }
@@ -727,14 +664,18 @@ namespace dauw
   {
     try
     {
-      // TODO: Properly parse the regex literal instead of making a literal string
-      auto string_value = utils::parse_string(current().value());
-      auto value = Value::of_obj(std::make_shared<ObjString>(string_value).get());
-      return std::make_shared<ExprLiteral>(value, current().location());
+      auto pattern = utils::parse_regex(current().value());
+      auto value = Value::of_obj(new ObjString(pattern.c_str()));
+      return arena_->make<ExprLiteral>(value, current().location());
+    }
+    catch (std::invalid_argument& ex)
+    {
+      report<SyntaxError>(current().location(), ex.what());
+      return nullptr;
     }
-    catch (...)
+    catch (utils::RegexException& ex)
     {
-      // TODO: Add proper catch
+      report<SyntaxError>(current().location(), ex.message());
       return nullptr;
     }
   }
@@ -761,7 +702,7 @@ namespace dauw
     consume(TokenKind::SQUARE_BRACKET_RIGHT, "in sequence atom");
 
     // Return a sequence expression containing the items
-    return std::make_shared<ExprSequence>(token, items);
+    return arena_->make<ExprSequence>(token, items);
   }
 
   // Parse a record expression
@@ -778,19 +719,22 @@ namespace dauw
     // Parse expressions until we reach the closing token
     do
     {
-      // Parse the name of the item
-      auto name = consume(TokenKind::IDENTIFIER, "in record atom").value();
+      // Parse the name of the item and check if it is not already defined
+      auto name_token = consume(TokenKind::IDENTIFIER, "in record atom");
+      auto name = name_token.value();
+      if (std::any_of(items.begin(), items.end(), [name](std::pair<string_t, expr_ptr>& item)->bool { return item.first == name; }))
+        throw report<SyntaxError>(name_token.location(), fmt::format("Duplicate name '{}' in record atom", name));
       consume(TokenKind::SYMBOL_COLON, "in record atom");
 
       // Parse the value of the item
-      items.insert(std::make_pair(name, parse_expression()));
+      items.push_back(std::make_pair(name, parse_expression()));
     } while (match(TokenKind::SYMBOL_COMMA));
 
     // Consume the closing token
     consume(TokenKind::CURLY_BRACKET_RIGHT, "in record atom");
 
     // Return a record expression containing the items
-    return std::make_shared<ExprRecord>(token, items);
+    return arena_->make<ExprRecord>(token, items);
   }
 
   // Parse a lambda expression
@@ -814,7 +758,7 @@ namespace dauw
     auto body = parse_assignment();
 
     // Return the function expression
-    return std::make_shared<ExprFunction>(token, parameters, return_type, body);
+    return arena_->make<ExprFunction>(token, parameters, return_type, body);
   }
 
   // Parse a grouped expression
@@ -828,7 +772,7 @@ namespace dauw
     consume(TokenKind::PARENTHESIS_RIGHT, "in grouped atom");
 
     // Return the grouped expression
-    return std::make_shared<ExprGrouped>(expr);
+    return arena_->make<ExprGrouped>(expr);
   }
 
   // --------------------------------------------------------------------------
@@ -860,7 +804,7 @@ namespace dauw
       auto right = parse_type_intersection();
 
       // Create the union type expression
-      left = std::make_shared<TypeExprUnion>(left, op, right);
+      left = arena_->make<TypeExprUnion>(left, op, right);
     }
 
     // Return the type expression
@@ -884,7 +828,7 @@ namespace dauw
       auto right = parse_type_maybe();
 
       // Create the union type expression
-      left = std::make_shared<TypeExprUnion>(left, op, right);
+      left = arena_->make<TypeExprUnion>(left, op, right);
     }
 
     // Return the type expression
@@ -905,7 +849,7 @@ namespace dauw
       auto op = current();
 
       // Create the maybe expression
-      return std::make_shared<TypeExprMaybe>(expr, op);
+      return arena_->make<TypeExprMaybe>(expr, op);
     }
 
     // Return the expression
@@ -922,7 +866,7 @@ namespace dauw
 
     // Parse the name
     auto name = consume(TokenKind::IDENTIFIER, "in type");
-    auto expr = std::make_shared<TypeExprName>(name);
+    auto expr = arena_->make<TypeExprName>(name);
 
     // Check for generic arguments
     if (match(TokenKind::SQUARE_BRACKET_LEFT))
@@ -934,7 +878,7 @@ namespace dauw
       auto arguments = parse_type_arguments();
 
       // Create the generic expression
-      return std::make_shared<TypeExprGeneric>(expr, token, arguments);
+      return arena_->make<TypeExprGeneric>(expr, token, arguments);
     }
 
     // Return the expression
@@ -952,7 +896,7 @@ namespace dauw
     consume(TokenKind::PARENTHESIS_RIGHT, "in grouped type");
 
     // Return the grouped expression
-    return std::make_shared<TypeExprGrouped>(expr);
+    return arena_->make<TypeExprGrouped>(expr);
   }
 
   // --------------------------------------------------------------------------
@@ -979,7 +923,7 @@ namespace dauw
         auto type = parse_type();
 
         // Create the expression and add it to the parameters
-        parameters.push_back(std::make_shared<ExprFunctionParameter>(name, type));
+        parameters.push_back(arena_->make<ExprFunctionParameter>(name, type));
       } while (match(TokenKind::SYMBOL_COMMA));
     }
 
@@ -2,6 +2,7 @@
 
 #include <dauw/common.hpp>
 #include <dauw/errors.hpp>
+#include <dauw/ast/arena.hpp>
 #include <dauw/ast/expr.hpp>
 #include <dauw/ast/type_expr.hpp>
 #include <dauw/frontend/lexer.hpp>
@@ -10,25 +11,60 @@
 #include <dauw/internals/string_object.hpp>
 #include <dauw/internals/type.hpp>
 #include <dauw/internals/value.hpp>
+#include <dauw/utils/regex.hpp>
 
-#include <functional>
+#include <array>
 
 
 namespace dauw
 {
-  // Class that defines a parser that converts a deque of tokens into an expression
+  // Enum that defines the precedence of an operator, from the loosest to the tightest binding
+  enum class ParserPrecedence : uint8_t
+  {
+    NONE,
+    LOGIC_OR,
+    LOGIC_AND,
+    LOGIC_NOT,
+    EQUALITY,
+    COMPARISON,
+    THREEWAY,
+    RANGE,
+    TERM,
+    FACTOR,
+    UNARY,
+  };
+
+
+  // Structure that defines how a token kind is parsed as an infix operator
+  struct ParserInfixRule
+  {
+    // The precedence of the operator, or none if the token kind is not an infix operator
+    ParserPrecedence precedence;
+
+    // Indicator if the operator can be chained with operators of the same precedence
+    bool chains;
+  };
+
+
+  // Class that defines a parser that converts the tokens of a lexer into an expression
   class Parser : public ReporterAware
   {
     private:
-      // Type declaration for a parser function
-      using parser_function_type = std::function<expr_ptr(Parser*)>;
+      // Infix rules for the parser indexed by token kind
+      static const std::array<ParserInfixRule, 256> infix_rules_;
 
 
-      // The tokens to parse
-      Lexer::token_list_type tokens_;
+      // The arena in which the parsed nodes are allocated
+      Arena* arena_;
 
-      // The index of the token that is currently being parsed
-      size_t index_;
+      // The lexer that produces the tokens to parse on demand
+      Lexer* lexer_;
+
+      // The token that is currently being parsed
+      Token current_;
+
+      // The token past the current token
+      Token next_;
 
       // The last full line comment that has been parsed
       string_t line_comment_;
@@ -36,21 +72,15 @@ namespace dauw
 
       // Basic parser functionality
       bool at_end();
-      Token current();
-      Token next();
-      Token advance();
+      Token& current();
+      Token& next();
+      Token& advance();
       bool check(TokenKind kind);
       bool match(TokenKind kind);
       bool match(std::initializer_list<TokenKind> kinds);
       Token consume(TokenKind kind, string_t context);
       void synchronize();
 
-      // Parser helper functions
-      expr_ptr parse_infix_op(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand);
-      expr_ptr parse_infix_op_single(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand);
-      expr_ptr parse_prefix_op(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand);
-      expr_ptr parse_prefix_op_single(std::initializer_list<TokenKind> op_kinds, parser_function_type parse_operand);
-
       // Parsers for expressions
       expr_ptr parse_script();
       expr_ptr parse_line();
@@ -65,16 +95,7 @@ namespace dauw
       expr_ptr parse_until();
       expr_ptr parse_block();
       expr_ptr parse_operation();
-      expr_ptr parse_logic_or();
-      expr_ptr parse_logic_and();
-      expr_ptr parse_logic_not();
-      expr_ptr parse_equality();
-      expr_ptr parse_comparison();
-      expr_ptr parse_threeway();
-      expr_ptr parse_range();
-      expr_ptr parse_term();
-      expr_ptr parse_factor();
-      expr_ptr parse_unary();
+      expr_ptr parse_precedence(ParserPrecedence precedence);
       expr_ptr parse_primary();
       expr_ptr parse_atom();
       expr_ptr parse_int();
@@ -103,9 +124,9 @@ namespace dauw
 
     public:
       // Constructor
-      Parser(Reporter* reporter, Lexer::token_list_type tokens);
+      Parser(Reporter* reporter, Arena* arena, Lexer* lexer);
 
-      // Parse a deque of tokens into an expression
+      // Parse the tokens of the lexer into an expression
       expr_ptr parse();
   };
 }
@@ -1,10 +1,14 @@
 #include "source.hpp"
 
+#ifdef DAUW_SOURCE_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 namespace dauw
 {
-  // Initialize the regex patterns for the source
-  utils::Regex Source::line_pattern_("\\r?\\n");
-
   // Create a shared pointer to a source
   source_ptr Source::create(string_t file, string_t source)
   {
@@ -17,15 +21,84 @@ namespace dauw
     if (!std::filesystem::exists(file))
       throw SourceException(fmt::format("The file '{}' does not exist", file));
 
-    auto stream = std::ifstream(file);
-    auto source = string_t(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
-    return create(std::filesystem::canonical(file), source);
+    return std::make_shared<Source>(std::filesystem::canonical(file));
   }
 
-  // Constructor for a source file
+  // Constructor for a source from a string
   Source::Source(string_t file, string_t source)
-    : file_(file), source_(source), source_lines_(line_pattern_.split(source_))
+    : file_(file), buffer_(std::move(source)), mapping_(nullptr)
+  {
+    source_ = string_view_t(buffer_);
+    prepare_();
+  }
+
+  // Constructor for a source read from a file
+  Source::Source(string_t file)
+    : file_(file), mapping_(nullptr)
+  {
+#ifdef DAUW_SOURCE_MMAP
+    // Map the file into memory, so its contents are not copied
+    auto descriptor = ::open(file_.c_str(), O_RDONLY);
+    if (descriptor < 0)
+      throw SourceException(fmt::format("The file '{}' could not be opened", file_));
+
+    struct stat status;
+    if (::fstat(descriptor, &status) == 0 && status.st_size > 0)
+    {
+      auto mapping = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (mapping != MAP_FAILED)
+      {
+        mapping_ = mapping;
+        source_ = string_view_t(static_cast<const char*>(mapping), status.st_size);
+      }
+    }
+    ::close(descriptor);
+#endif
+
+    // If the file could not be mapped, then read it into the buffer instead
+    if (mapping_ == nullptr)
+    {
+      auto stream = std::ifstream(file_, std::ios::binary | std::ios::ate);
+      if (!stream)
+        throw SourceException(fmt::format("The file '{}' could not be opened", file_));
+
+      buffer_.resize(static_cast<size_t>(stream.tellg()));
+      stream.seekg(0);
+      stream.read(buffer_.data(), buffer_.size());
+      source_ = string_view_t(buffer_);
+    }
+
+    prepare_();
+  }
+
+  // Destructor for a source
+  Source::~Source()
+  {
+#ifdef DAUW_SOURCE_MMAP
+    if (mapping_ != nullptr)
+      ::munmap(mapping_, source_.size());
+#endif
+  }
+
+  // Validate the source string and index the lines of the source
+  void Source::prepare_()
   {
+    // Validate the source once, so the lexer doesn't have to check the encoding of every line it matches against
+    if (!utils::utf8_is_valid(source_.data(), source_.size()))
+      throw SourceException(fmt::format("The source of '{}' is not a valid UTF-8 encoded string", file_));
+
+    // Index the start of every line, where a line terminator at the end of the source doesn't start another line
+    auto begin = source_.data();
+    auto end = begin + source_.size();
+
+    line_offsets_.push_back(0);
+    for (auto p = begin; p < end; p ++)
+    {
+      p = static_cast<const char*>(std::memchr(p, '\n', end - p));
+      if (p == nullptr || p + 1 == end)
+        break;
+      line_offsets_.push_back(p + 1 - begin);
+    }
   }
 
   // Return the file of the source
@@ -35,30 +108,47 @@ namespace dauw
   }
 
   // Return the source string of the source
-  string_t& Source::source()
+  string_view_t Source::source()
   {
     return source_;
   }
 
-  // Return the lines of the source
-  std::vector<string_t> Source::source_lines()
+  // Return the number of lines of the source
+  size_t Source::line_count()
   {
-    return source_lines_;
+    return line_offsets_.size();
+  }
+
+  // Return the line at the specified index of the source, without its line terminator
+  string_view_t Source::line(size_t index)
+  {
+    auto start = line_offsets_[index];
+    auto end = index + 1 < line_offsets_.size() ? line_offsets_[index + 1] : source_.size();
+
+    // Strip the line terminator, which is either "\n" or "\r\n"
+    if (end > start && source_[end - 1] == '\n')
+    {
+      end --;
+      if (end > start && source_[end - 1] == '\r')
+        end --;
+    }
+
+    return source_.substr(start, end - start);
   }
 
   // Format a location in the source
   string_t Source::format(Location location)
   {
-    if (location.line() >= source_lines_.size())
+    if (location.line() >= line_count())
       throw SourceException(fmt::format("line {} is not present in {}", location.line() + 1, file_));
 
-    auto line = source_lines_[location.line()];
+    auto line = this->line(location.line());
     if (location.col() > line.length())
       throw SourceException(fmt::format("line {}, col {} is not present in {}", location.line() + 1, location.col() + 1, file_));
 
     string_t format;
     format.append(fmt::format("{}, {}\n", file_, location));
-    format.append(fmt::format("{:>4d} │ {}\n", location.line() + 1, source_lines_[location.line()]));
+    format.append(fmt::format("{:>4d} │ {}\n", location.line() + 1, line));
     format.append(fmt::format("     │ {}^", utils::repeat(" ", location.col())));
     return format;
   }
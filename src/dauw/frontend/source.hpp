@@ -2,13 +2,18 @@
 
 #include <dauw/common.hpp>
 #include <dauw/frontend/location.hpp>
-#include <dauw/utils/regex.hpp>
 #include <dauw/utils/string.hpp>
 
 #include <filesystem>
 #include <fstream>
 
 
+// Defines for memory mapping of source files, which is available on POSIX systems
+#if !defined(DAUW_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+  #define DAUW_SOURCE_MMAP
+#endif
+
+
 namespace dauw
 {
   // Forward declarations
@@ -23,18 +28,24 @@ namespace dauw
   class Source
   {
     private:
-      // Initialize the regex patterns for the source
-      static utils::Regex line_pattern_;
-
-
       // The file of the source
       string_t file_;
 
+      // The buffer that owns the source string if the source is not memory mapped
+      string_t buffer_;
+
+      // The memory mapping of the source file, or nullptr if the source is not memory mapped
+      void* mapping_;
+
       // The source string of the source
-      string_t source_;
+      string_view_t source_;
 
-      // The source string split by line of the source
-      std::vector<string_t> source_lines_;
+      // The offsets in the source string at which the lines of the source start
+      std::vector<size_t> line_offsets_;
+
+
+      // Validate the source string and index the lines of the source
+      void prepare_();
 
 
     public:
@@ -47,15 +58,26 @@ namespace dauw
 
       // Constructor
       Source(string_t file, string_t source);
+      Source(string_t file);
+
+      // Disable copying of the source, since it may own a memory mapping
+      Source(const Source& other) = delete;
+      Source& operator=(const Source& other) = delete;
+
+      // Destructor
+      ~Source();
 
       // Return the file of the source
       string_t& file();
 
       // Return the source string of the source
-      string_t& source();
+      string_view_t source();
+
+      // Return the number of lines of the source
+      size_t line_count();
 
-      // Return The source string split by line of the source
-      std::vector<string_t> source_lines();
+      // Return the line at the specified index of the source, without its line terminator
+      string_view_t line(size_t index);
 
       // Format a location in the source
       string_t format(Location location);
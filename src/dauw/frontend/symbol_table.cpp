@@ -0,0 +1,52 @@
+#include "symbol_table.hpp"
+
+namespace dauw
+{
+  // The texts of the symbols indexed by their id, where id 0 is the empty text
+  std::deque<string_t> SymbolTable::texts_({""});
+
+  // The ids of the symbols mapped by their text
+  std::unordered_map<string_view_t, symbol_t> SymbolTable::ids_({{"", 0}});
+
+  // The mutex that guards the table
+  std::mutex SymbolTable::mutex_;
+
+
+  // Return the id of the symbol with the specified text, or intern the text if it doesn't exist yet
+  symbol_t SymbolTable::intern(string_view_t text)
+  {
+    // Look up the symbol in the cache of the current thread first, which doesn't need the lock
+    thread_local std::unordered_map<string_view_t, symbol_t> cache({{"", 0}});
+    auto cached = cache.find(text);
+    if (cached != cache.end())
+      return cached->second;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = ids_.find(text);
+    if (it == ids_.end())
+    {
+      // The texts are stored in a deque, so the views that key the maps stay valid when new texts are appended
+      auto id = static_cast<symbol_t>(texts_.size());
+      auto& stored = texts_.emplace_back(text);
+      it = ids_.emplace(string_view_t(stored), id).first;
+    }
+
+    cache.emplace(it->first, it->second);
+    return it->second;
+  }
+
+  // Return the text of the symbol with the specified id
+  const string_t& SymbolTable::text(symbol_t id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return texts_[id];
+  }
+
+  // Return the number of interned symbols
+  size_t SymbolTable::count()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return texts_.size();
+  }
+}
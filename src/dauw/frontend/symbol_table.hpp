@@ -0,0 +1,39 @@
+#pragma once
+
+#include <dauw/common.hpp>
+
+#include <deque>
+#include <mutex>
+
+
+namespace dauw
+{
+  // Type definition for the id of an interned symbol
+  using symbol_t = uint32_t;
+
+
+  // Class that defines the process-wide table of interned symbols, which stores the text of tokens once
+  class SymbolTable
+  {
+    private:
+      // The texts of the symbols indexed by their id, where id 0 is the empty text
+      static std::deque<string_t> texts_;
+
+      // The ids of the symbols mapped by their text
+      static std::unordered_map<string_view_t, symbol_t> ids_;
+
+      // The mutex that guards the table, since tokens are created on multiple threads by the parallel lexer
+      static std::mutex mutex_;
+
+
+    public:
+      // Return the id of the symbol with the specified text, or intern the text if it doesn't exist yet
+      static symbol_t intern(string_view_t text);
+
+      // Return the text of the symbol with the specified id
+      static const string_t& text(symbol_t id);
+
+      // Return the number of interned symbols
+      static size_t count();
+  };
+}
@@ -3,14 +3,14 @@
 namespace dauw
 {
   // Constructor for a token
-  Token::Token(TokenKind kind, string_t value, Location location)
-    : kind_(kind), value_(value), location_(location)
+  Token::Token(TokenKind kind, string_view_t value, Location location)
+    : kind_(kind), value_(SymbolTable::intern(value)), location_(location)
   {
   }
 
   // Constructor for a token without a value
   Token::Token(TokenKind kind, Location location)
-    : kind_(kind), value_(""), location_(location)
+    : kind_(kind), value_(0), location_(location)
   {
   }
 
@@ -21,7 +21,13 @@ namespace dauw
   }
 
   // Return the value of the token
-  string_t& Token::value()
+  const string_t& Token::value()
+  {
+    return SymbolTable::text(value_);
+  }
+
+  // Return the symbol of the value of the token
+  symbol_t Token::symbol()
   {
     return value_;
   }
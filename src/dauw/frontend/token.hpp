@@ -2,6 +2,7 @@
 
 #include <dauw/common.hpp>
 #include <dauw/frontend/location.hpp>
+#include <dauw/frontend/symbol_table.hpp>
 
 
 namespace dauw
@@ -50,6 +51,7 @@ namespace dauw
     OPERATOR_GREATER_EQUAL,
     OPERATOR_MATCH,
     OPERATOR_NOT_MATCH,
+    OPERATOR_CAPTURE,
     OPERATOR_EQUAL,
     OPERATOR_NOT_EQUAL,
     OPERATOR_IDENTICAL,
@@ -86,15 +88,15 @@ namespace dauw
   };
 
 
-  // Class that defines a token in a source string
+  // Class that defines a token in a source string, which stores its value as an interned symbol to keep it at 16 bytes
   class Token
   {
     private:
       // The kind of the token
       TokenKind kind_;
 
-      // The value of the token
-      string_t value_;
+      // The symbol of the value of the token
+      symbol_t value_;
 
       // The location of the token
       Location location_;
@@ -102,14 +104,17 @@ namespace dauw
 
     public:
       // Constructor
-      Token(TokenKind kind, string_t value, Location location);
+      Token(TokenKind kind, string_view_t value, Location location);
       Token(TokenKind kind, Location location);
 
       // Return the kind of the token
       TokenKind& kind();
 
       // Return the value of the token
-      string_t& value();
+      const string_t& value();
+
+      // Return the symbol of the value of the token
+      symbol_t symbol();
 
       // Return the location of the token
       Location& location();
@@ -168,6 +173,7 @@ namespace fmt
         case TokenKind::OPERATOR_GREATER_EQUAL: return "greater than or equal operator";
         case TokenKind::OPERATOR_MATCH: return "match operator";
         case TokenKind::OPERATOR_NOT_MATCH: return "not match operator";
+        case TokenKind::OPERATOR_CAPTURE: return "capture operator";
         case TokenKind::OPERATOR_EQUAL: return "equal operator";
         case TokenKind::OPERATOR_NOT_EQUAL: return "not equal operator";
         case TokenKind::OPERATOR_IDENTICAL: return "identical operator";
@@ -59,26 +59,52 @@ namespace dauw
   // Format an object
   string_t format_obj(Obj* obj, bool repr)
   {
-    //if (obj->type() == Type::type_record)
-    //  return format_obj_record(static_cast<ObjRecord*>(obj), repr);
-    //else if (obj->type() == Type::type_sequence)
-    //  return format_obj_sequence(static_cast<ObjSequence*>(obj), repr);
-    if (obj->type() == Type::type_string)
+    if (obj->type() == Type::type_record)
+      return format_obj_record(static_cast<ObjRecord*>(obj), repr);
+    else if (obj->type() == Type::type_sequence)
+      return format_obj_sequence(static_cast<ObjSequence*>(obj), repr);
+    else if (obj->type() == Type::type_function)
+      return format_obj_function((ObjFunction*)obj, repr);
+    else if (obj->type() == Type::type_string)
       return format_obj_string((ObjString*)obj, repr);
     else
       return fmt::format("<object {} at {:#014x}>", obj->type(), (uintptr_t)(obj));
   }
 
+  // Format a function object
+  string_t format_obj_function(ObjFunction* obj, bool repr)
+  {
+    return fmt::format("<function {}>", obj->name());
+  }
+
   // Format a record object
   string_t format_obj_record(ObjRecord* obj, bool repr)
   {
-    return "{}";
+    auto names = obj->shape()->names();
+
+    string_t result = "{";
+    for (size_t i = 0; i < names.size(); i ++)
+    {
+      if (i > 0)
+        result.append(", ");
+      result.append(fmt::format("{}: {}", names[i], format(obj->slot(i), true)));
+    }
+    result.append("}");
+    return result;
   }
 
   // Format a sequence object
   string_t format_obj_sequence(ObjSequence* obj, bool repr)
   {
-    return "[]";
+    string_t result = "[";
+    for (auto it = obj->begin(); it != obj->end(); it ++)
+    {
+      if (it != obj->begin())
+        result.append(", ");
+      result.append(format(*it, true));
+    }
+    result.append("]");
+    return result;
   }
 
   // Format a string object
@@ -88,6 +114,6 @@ namespace dauw
     //for (auto it = obj->begin(); it != obj->end(); it++)
     //  utf8::append((char32_t)*it, u);
 
-    return fmt::format("{}", obj->c_str());
+    return fmt::format("{}", obj->view());
   }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <dauw/common.hpp>
+#include <dauw/internals/function_object.hpp>
 #include <dauw/internals/object.hpp>
 #include <dauw/internals/record_object.hpp>
 #include <dauw/internals/sequence_object.hpp>
@@ -32,6 +33,9 @@ namespace dauw
   // Format an object
   string_t format_obj(Obj* obj, bool repr = false);
 
+  // Format a function object
+  string_t format_obj_function(ObjFunction* obj, bool repr = false);
+
   // Format a record object
   string_t format_obj_record(ObjRecord* obj, bool repr = false);
 
@@ -0,0 +1,44 @@
+#include "function_object.hpp"
+
+namespace dauw
+{
+  // Constructor for a function
+  ObjFunction::ObjFunction(string_t name, size_t arity)
+    : Obj(Type::type_function), name_(name), arity_(arity)
+  {
+  }
+
+  // Return the name of the function
+  string_t& ObjFunction::name()
+  {
+    return name_;
+  }
+
+  // Return the number of parameters of the function
+  size_t ObjFunction::arity()
+  {
+    return arity_;
+  }
+
+  // Return the bytecode chunk of the function
+  Chunk& ObjFunction::chunk()
+  {
+    return chunk_;
+  }
+
+  // Return the number of bytes of heap memory that are owned by the function
+  size_t ObjFunction::size()
+  {
+    return sizeof(ObjFunction) + chunk_.size() * (sizeof(uint8_t) + sizeof(Location)) + chunk_.constants().size() * sizeof(Value);
+  }
+
+  // Add the objects that are referenced by the function to the specified list
+  void ObjFunction::trace(std::vector<Obj*>& objects)
+  {
+    for (auto constant : chunk_.constants())
+    {
+      if (constant.is_obj())
+        objects.push_back(constant.as_obj());
+    }
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <dauw/common.hpp>
+#include <dauw/backend/chunk.hpp>
+#include <dauw/internals/object.hpp>
+
+
+namespace dauw
+{
+  // Class that defines a function that is compiled to bytecode
+  class ObjFunction : public Obj
+  {
+    private:
+      // The name of the function
+      string_t name_;
+
+      // The number of parameters of the function
+      size_t arity_;
+
+      // The bytecode chunk of the function
+      Chunk chunk_;
+
+
+    public:
+      // Constructor
+      ObjFunction(string_t name, size_t arity);
+
+      // Return the name of the function
+      string_t& name();
+
+      // Return the number of parameters of the function
+      size_t arity();
+
+      // Return the bytecode chunk of the function
+      Chunk& chunk();
+
+      // Return the number of bytes of heap memory that are owned by the function
+      virtual size_t size() override;
+
+      // Add the objects that are referenced by the function to the specified list
+      virtual void trace(std::vector<Obj*>& objects) override;
+  };
+}
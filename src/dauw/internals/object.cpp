@@ -4,7 +4,7 @@ namespace dauw
 {
   // Constructor for an object
   Obj::Obj(Type type)
-    : type_(type)
+    : type_(type), marked_(false)
   {
   }
 
@@ -13,4 +13,27 @@ namespace dauw
   {
     return type_;
   }
+
+  // Return if the object has been marked as reachable by the garbage collector
+  bool Obj::marked()
+  {
+    return marked_;
+  }
+
+  // Set if the object has been marked as reachable by the garbage collector
+  void Obj::set_marked(bool marked)
+  {
+    marked_ = marked;
+  }
+
+  // Return the number of bytes of heap memory that are owned by the object
+  size_t Obj::size()
+  {
+    return sizeof(Obj);
+  }
+
+  // Add the objects that are referenced by the object to the specified list
+  void Obj::trace(std::vector<Obj*>& /*objects*/)
+  {
+  }
 }
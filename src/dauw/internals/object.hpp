@@ -15,6 +15,9 @@ namespace dauw
       // The type of the object
       Type type_;
 
+      // Indicate if the object has been marked as reachable by the garbage collector
+      bool marked_;
+
 
     public:
       // Constructor
@@ -25,5 +28,17 @@ namespace dauw
 
       // Return the type of the object
       Type& type();
+
+      // Return if the object has been marked as reachable by the garbage collector
+      bool marked();
+
+      // Set if the object has been marked as reachable by the garbage collector
+      void set_marked(bool marked);
+
+      // Return the number of bytes of heap memory that are owned by the object
+      virtual size_t size();
+
+      // Add the objects that are referenced by the object to the specified list
+      virtual void trace(std::vector<Obj*>& objects);
   };
 }
@@ -4,51 +4,93 @@ namespace dauw
 {
   // Constructor for a record
   ObjRecord::ObjRecord(std::initializer_list<ObjRecord::container_value_type> items)
-    : Obj(Type::type_record)
+    : Obj(Type::type_record), shape_(Shape::root())
   {
-    if (items.size() > 0)
-      container_ = container_type(items.begin(), items.end());
-    else
-      container_ = container_type();
+    for (auto item : items)
+      put(item.first, item.second);
   }
 
-  // Iterate over the items in the container
-  ObjRecord::container_type::const_iterator ObjRecord::begin()
+  // Constructor for a record with the specified shape and the values of its slots
+  ObjRecord::ObjRecord(Shape* shape, const Value* values)
+    : Obj(Type::type_record), shape_(shape), slots_(values, values + shape->slot_count())
   {
-    return container_.cbegin();
   }
-  ObjRecord::container_type::const_iterator ObjRecord::end()
+
+  // Return the shape of the record
+  Shape* ObjRecord::shape()
+  {
+    return shape_;
+  }
+
+  // Return the value in the specified slot of the record
+  Value& ObjRecord::slot(size_t index)
   {
-    return container_.cend();
+    return slots_[index];
   }
 
   // Return if the record contains a value with the specified name
   bool ObjRecord::contains(string_t name)
   {
-    return container_.count(name) > 0;
+    return shape_->slot(name).has_value();
   }
 
   // Return the value with the specified name in the record
   Value ObjRecord::get(string_t name)
   {
-    auto it = container_.find(name);
-    if (it == container_.end())
+    auto index = shape_->slot(name);
+    if (!index.has_value())
       throw std::out_of_range(fmt::format("Name {} out of range", name));
 
-    return std::get<1>(*it);
+    return slots_[index.value()];
   }
 
   // Put the specified value at the specified name in the record
   void ObjRecord::put(string_t name, Value value)
   {
-    container_.insert(std::make_pair(name, value));
+    // Replace the value if the record already contains the name
+    auto index = shape_->slot(name);
+    if (index.has_value())
+    {
+      slots_[index.value()] = value;
+      return;
+    }
+
+    // Otherwise transition to the shape with the added name
+    shape_ = shape_->transition(name);
+    slots_.push_back(value);
   }
 
   // Remove a value with the specified name from the record
   void ObjRecord::remove(string_t name)
   {
-    auto it = container_.find(name);
-    if (it != container_.end())
-      container_.erase(it);
+    auto index = shape_->slot(name);
+    if (!index.has_value())
+      return;
+
+    // Rebuild the shape from the root without the removed name
+    auto names = shape_->names();
+    shape_ = Shape::root();
+    for (auto& other_name : names)
+    {
+      if (other_name != name)
+        shape_ = shape_->transition(other_name);
+    }
+    slots_.erase(slots_.begin() + index.value());
+  }
+
+  // Return the number of bytes of heap memory that are owned by the record
+  size_t ObjRecord::size()
+  {
+    return sizeof(ObjRecord) + slots_.capacity() * sizeof(Value);
+  }
+
+  // Add the objects that are referenced by the record to the specified list
+  void ObjRecord::trace(std::vector<Obj*>& objects)
+  {
+    for (auto value : slots_)
+    {
+      if (value.is_obj())
+        objects.push_back(value.as_obj());
+    }
   }
 }
@@ -2,34 +2,39 @@
 
 #include <dauw/common.hpp>
 #include <dauw/internals/object.hpp>
+#include <dauw/internals/shape.hpp>
 #include <dauw/internals/value.hpp>
 
-#include <unordered_map>
-
 
 namespace dauw
 {
-  // Class that defines a implementation for Record using std::unordered_map<T>
+  // Class that defines a implementation for Record using a shape and a contiguous array of slots
   class ObjRecord : public Obj
   {
     public:
       // Type definition for the backing C++ container
-      using container_type = std::unordered_map<string_t, Value>;
-      using container_value_type = container_type::value_type;
+      using container_type = std::vector<Value>;
+      using container_value_type = std::pair<string_t, Value>;
 
 
     private:
-      // The backing C++ container of the list
-      container_type container_;
+      // The shape of the record
+      Shape* shape_;
 
-      // Iterate over the items in the container
-      container_type::const_iterator begin();
-      container_type::const_iterator end();
+      // The values of the fields of the record in slot order
+      container_type slots_;
 
 
     public:
       // Constructor
       ObjRecord(std::initializer_list<container_value_type> items = {});
+      ObjRecord(Shape* shape, const Value* values);
+
+      // Return the shape of the record
+      Shape* shape();
+
+      // Return the value in the specified slot of the record
+      Value& slot(size_t index);
 
       // Return if the record contains a value with the specified name
       bool contains(string_t name);
@@ -42,5 +47,11 @@ namespace dauw
 
       // Remove a value with the specified name from the record
       void remove(string_t name);
+
+      // Return the number of bytes of heap memory that are owned by the record
+      virtual size_t size() override;
+
+      // Add the objects that are referenced by the record to the specified list
+      virtual void trace(std::vector<Obj*>& objects) override;
   };
 }
@@ -4,12 +4,28 @@ namespace dauw
 {
   // Constructor for a sequence
   ObjSequence::ObjSequence(std::initializer_list<Value> items)
-    : Obj(Type::type_sequence)
+    : Obj(Type::type_sequence), container_(items)
   {
-    if (items.size() > 0)
-      container_ = container_type(items.begin(), items.end());
+  }
+
+  // Constructor for a sequence from an array of items
+  ObjSequence::ObjSequence(const Value* items, size_t count)
+    : Obj(Type::type_sequence), container_(items, items + count)
+  {
+  }
+
+  // Return the offset in the container of the specified index, which counts from the end if negative
+  size_t ObjSequence::offset(int index, bool allow_end)
+  {
+    auto length = static_cast<int>(container_.size());
+    auto limit = allow_end ? length + 1 : length;
+
+    if (index >= 0 && index < limit)
+      return static_cast<size_t>(index);
+    else if (index < 0 && index >= -length)
+      return static_cast<size_t>(length + index);
     else
-      container_ = container_type();
+      throw std::out_of_range(fmt::format("Index {} is out of range", index));
   }
 
   // Iterate over the items in the container
@@ -22,33 +38,14 @@ namespace dauw
     return container_.cend();
   }
 
-  // Return an iterator at a specified index
-  ObjSequence::container_type::const_iterator ObjSequence::pos(int index)
-  {
-    if (index >= 0 && index < container_.size())
-    {
-      auto it = container_.cbegin();
-      for (auto i = 0; i < index;)
-        it ++;
-      return it;
-    }
-    else if (index < 0 && index <= -container_.size())
-    {
-      auto it = container_.cbegin();
-      for (auto i = 0; i < container_.size() - index;)
-        it ++;
-      return it;
-    }
-    else
-      throw std::out_of_range(fmt::format("Index {} is out of range", index));
-  }
-
   // Return if the collection contains the specified item
   bool ObjSequence::contains(Value item)
   {
-    for (auto it = container_.cbegin(); it != container_.cend(); it ++)
+    auto data = container_.data();
+    auto count = container_.size();
+    for (size_t i = 0; i < count; i ++)
     {
-      if (item == *it)
+      if (item == data[i])
         return true;
     }
     return false;
@@ -69,8 +66,7 @@ namespace dauw
   // Return the item at the specified index in the sequence
   Value ObjSequence::at(int index)
   {
-    auto it = pos(index);
-    return *it;
+    return container_[offset(index)];
   }
 
   // Add the specified item to the collection
@@ -80,40 +76,46 @@ namespace dauw
   }
 
   // Add all of the items in the specified collection to the collection
-  void ObjSequence::add_all(ObjSequence items)
+  void ObjSequence::add_all(ObjSequence& items)
   {
-    for (auto it = items.container_.cbegin(); it != items.container_.cend(); it ++)
-      add(*it);
+    auto count = items.container_.size();
+    if (count == 0)
+      return;
+
+    // Reserve the space first, so the items are not moved if the collection is added to itself
+    auto length = container_.size();
+    container_.reserve(length + count);
+    container_.resize(length + count, Value::value_nothing);
+    std::memcpy(container_.data() + length, items.container_.data(), count * sizeof(Value));
   }
 
   // Remove a single instance of the specified item from the collection
   void ObjSequence::remove(Value item)
   {
-    for (auto it = container_.cbegin(); it != container_.cend(); it ++)
+    for (auto it = container_.begin(); it != container_.end(); it ++)
     {
       if (item == *it)
+      {
         container_.erase(it);
+        return;
+      }
     }
   }
 
   // Remove all of the items in the specified collection from the collection
-  void ObjSequence::remove_all(ObjSequence items)
+  void ObjSequence::remove_all(ObjSequence& items)
   {
-    for (auto items_it = items.container_.cbegin(); items_it != items.container_.cend(); items_it ++)
-    {
-      if (contains(*items_it))
-        remove(*items_it);
-    }
+    container_.erase(std::remove_if(container_.begin(), container_.end(), [&items](Value& item)->bool {
+      return items.contains(item);
+    }), container_.end());
   }
 
   // Remove all of the items in the collection apart from the items in the specified collection
-  void ObjSequence::retain_all(ObjSequence items)
+  void ObjSequence::retain_all(ObjSequence& items)
   {
-    for (auto items_it = items.container_.cbegin(); items_it != items.container_.cend(); items_it ++)
-    {
-      if (!contains(*items_it))
-        remove(*items_it);
-    }
+    container_.erase(std::remove_if(container_.begin(), container_.end(), [&items](Value& item)->bool {
+      return !items.contains(item);
+    }), container_.end());
   }
 
   // Removes all of the items in the collection
@@ -125,22 +127,34 @@ namespace dauw
   // Insert the specified item at the specified index to the sequence
   void ObjSequence::insert(int index, Value item)
   {
-    auto it = pos(index);
-    container_.insert(it, item);
+    container_.insert(container_.begin() + offset(index, true), item);
   }
 
   // Replace the specified item at the specified index in the sequence
   void ObjSequence::replace(int index, Value item)
   {
-    auto it = pos(index);
-    auto insert_it = container_.erase(it);
-    container_.insert(insert_it, item);
+    container_[offset(index)] = item;
   }
 
   // Erase the specified item at the specified index in the sequence
   void ObjSequence::erase(int index)
   {
-    auto it = pos(index);
-    container_.erase(it);
+    container_.erase(container_.begin() + offset(index));
+  }
+
+  // Return the number of bytes of heap memory that are owned by the sequence
+  size_t ObjSequence::size()
+  {
+    return sizeof(ObjSequence) + container_.capacity() * sizeof(Value);
+  }
+
+  // Add the objects that are referenced by the sequence to the specified list
+  void ObjSequence::trace(std::vector<Obj*>& objects)
+  {
+    for (auto item : container_)
+    {
+      if (item.is_obj())
+        objects.push_back(item.as_obj());
+    }
   }
 }
@@ -4,34 +4,36 @@
 #include <dauw/internals/object.hpp>
 #include <dauw/internals/value.hpp>
 
-#include <list>
+#include <algorithm>
+#include <cstring>
 
 
 namespace dauw
 {
-  // Class that defines a implementation for Sequence[T] using std::list<T>
+  // Class that defines a implementation for Sequence[T] using a contiguous std::vector<T>
   class ObjSequence : public Obj
   {
     public:
       // Type definition for the backing C++ container
-      using container_type = std::list<Value>;
+      using container_type = std::vector<Value>;
 
 
     private:
       // The backing C++ container of the sequence
       container_type container_;
 
-      // Iterate over the items in the container
-      container_type::const_iterator begin();
-      container_type::const_iterator end();
-
-      // Return an iterator at a specified index
-      container_type::const_iterator pos(int index);
+      // Return the offset in the container of the specified index, which counts from the end if negative
+      size_t offset(int index, bool allow_end = false);
 
 
     public:
       // Constructor
       ObjSequence(std::initializer_list<Value> items = {});
+      ObjSequence(const Value* items, size_t count);
+
+      // Iterate over the items in the container
+      container_type::const_iterator begin();
+      container_type::const_iterator end();
 
       // Return if the collection contains the specified item
       bool contains(Value item);
@@ -49,16 +51,16 @@ namespace dauw
       void add(Value item);
 
       // Add all of the items in the specified collection to the collection
-      void add_all(ObjSequence items);
+      void add_all(ObjSequence& items);
 
       // Remove a single instance of the specified item from the collection
       void remove(Value item);
 
       // Remove all of the items in the specified collection from the collection
-      void remove_all(ObjSequence items);
+      void remove_all(ObjSequence& items);
 
       // Remove all of the items in the collection apart from the items in the specified collection
-      void retain_all(ObjSequence items);
+      void retain_all(ObjSequence& items);
 
       // Removes all of the items in the collection
       void clear();
@@ -71,5 +73,11 @@ namespace dauw
 
       // Erase the specified item at the specified index in the sequence
       void erase(int index);
+
+      // Return the number of bytes of heap memory that are owned by the sequence
+      virtual size_t size() override;
+
+      // Add the objects that are referenced by the sequence to the specified list
+      virtual void trace(std::vector<Obj*>& objects) override;
   };
 }
@@ -0,0 +1,69 @@
+#include "shape.hpp"
+
+namespace dauw
+{
+  // Constructor for a shape that adds a field to a parent shape
+  Shape::Shape(Shape* parent, string_t name)
+    : parent_(parent), name_(name), slot_count_(parent->slot_count_ + 1)
+  {
+  }
+
+  // Constructor for the empty root shape
+  Shape::Shape()
+    : parent_(nullptr), slot_count_(0)
+  {
+  }
+
+  // Return the parent shape of the shape
+  Shape* Shape::parent()
+  {
+    return parent_;
+  }
+
+  // Return the field names of the shape in slot order
+  std::vector<string_t> Shape::names()
+  {
+    // Walk the shape chain, which visits the names from the last slot to the first one
+    std::vector<string_t> names(slot_count_);
+    for (auto shape = this; shape->parent_ != nullptr; shape = shape->parent_)
+      names[shape->slot_count_ - 1] = shape->name_;
+    return names;
+  }
+
+  // Return the number of slots of the shape
+  size_t Shape::slot_count()
+  {
+    return slot_count_;
+  }
+
+  // Return the slot of the field with the specified name
+  std::optional<size_t> Shape::slot(string_t name)
+  {
+    // Walk the shape chain to find the shape that added the field
+    for (auto shape = this; shape->parent_ != nullptr; shape = shape->parent_)
+    {
+      if (shape->name_ == name)
+        return shape->slot_count_ - 1;
+    }
+    return std::nullopt;
+  }
+
+  // Return the child shape that adds the field with the specified name, creating it if it doesn't exist yet
+  Shape* Shape::transition(string_t name)
+  {
+    auto it = transitions_.find(name);
+    if (it != transitions_.end())
+      return it->second.get();
+
+    auto shape = new Shape(this, name);
+    transitions_.insert(std::make_pair(name, std::unique_ptr<Shape>(shape)));
+    return shape;
+  }
+
+  // Return the empty root shape
+  Shape* Shape::root()
+  {
+    static Shape root;
+    return &root;
+  }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <dauw/common.hpp>
+
+
+namespace dauw
+{
+  // Class that defines the shape of a record, which maps field names to slots and is shared by all records that are built with the same fields in the same order
+  class Shape
+  {
+    private:
+      // The parent shape of the shape, or nullptr if the shape is the root shape
+      Shape* parent_;
+
+      // The field name that the shape adds to its parent shape, which is stored in the last slot of the shape
+      string_t name_;
+
+      // The number of slots of the shape
+      size_t slot_count_;
+
+      // The child shapes of the shape mapped to the field name they add
+      std::unordered_map<string_t, std::unique_ptr<Shape>> transitions_;
+
+
+    public:
+      // Constructor
+      Shape(Shape* parent, string_t name);
+      Shape();
+
+      // Disable copying of the shape
+      Shape(const Shape& other) = delete;
+      Shape& operator=(const Shape& other) = delete;
+
+      // Return the parent shape of the shape
+      Shape* parent();
+
+      // Return the field names of the shape in slot order
+      std::vector<string_t> names();
+
+      // Return the number of slots of the shape
+      size_t slot_count();
+
+      // Return the slot of the field with the specified name
+      std::optional<size_t> slot(string_t name);
+
+      // Return the child shape that adds the field with the specified name, creating it if it doesn't exist yet
+      Shape* transition(string_t name);
+
+
+      // Return the empty root shape
+      static Shape* root();
+  };
+}
@@ -4,129 +4,174 @@ namespace dauw
 {
   // Default constructor for a string
   ObjString::ObjString()
-    : Obj(Type::type_string), length_(0)
+    : Obj(Type::type_string), length_(0), bytes_(inline_bytes_), parent_(nullptr)
   {
-    bytes_ = new char[length_ + 1];
-    bytes_[0] = '\0';
+    assign_("", 0);
   }
 
   // Constructor for a string from a C-string
   ObjString::ObjString(const char* bytes)
-    : Obj(Type::type_string), length_(std::strlen(bytes))
+    : Obj(Type::type_string), length_(0), bytes_(inline_bytes_), parent_(nullptr)
   {
     auto bytes_length = std::strlen(bytes);
-    if (!utf8::is_valid(bytes, bytes + bytes_length))
+    if (!utils::utf8_is_valid(bytes, bytes_length))
       throw StringException("The provided array of bytes is not a valid UTF-8 encoded string");
 
-    length_ = bytes_length;
-    bytes_ = new char[length_ + 1];
-    std::memcpy(bytes_, bytes, length_);
-    bytes_[length_] = '\0';
+    assign_(bytes, bytes_length);
   }
 
   // Constructor for a string from another string
   ObjString::ObjString(const ObjString& other)
-    : Obj(Type::type_string), length_(other.length_)
+    : Obj(Type::type_string), length_(0), bytes_(inline_bytes_), parent_(nullptr)
   {
-    bytes_ = new char[length_ + 1];
-    std::memcpy(bytes_, other.bytes_, length_);
-    bytes_[length_] = '\0';
+    assign_(other.bytes_, other.length_);
+  }
+
+  // Constructor for a slice that shares the buffer of a parent string, using byte offsets at code point boundaries
+  ObjString::ObjString(ObjString* parent, size_t offset, size_t length)
+    : Obj(Type::type_string), length_(length), parent_(parent)
+  {
+    if (offset + length > parent->length_)
+      throw std::out_of_range(fmt::format("{}", offset + length));
+
+    // Share the buffer of the parent of a slice directly, so slices never form chains
+    if (parent_->parent_ != nullptr)
+    {
+      offset += parent_->bytes_ - parent_->parent_->bytes_;
+      parent_ = parent_->parent_;
+    }
+
+    bytes_ = parent_->bytes_ + offset;
+    update_();
   }
 
   // Assignment for a string from a C-string
   ObjString& ObjString::operator=(const char* bytes)
   {
     auto bytes_length = std::strlen(bytes);
-    if (!utf8::is_valid(bytes, bytes + bytes_length))
+    if (!utils::utf8_is_valid(bytes, bytes_length))
       throw StringException("The provided array of bytes is not a valid UTF-8 encoded string");
 
-    delete[] bytes_;
-
-    length_ = bytes_length;
-    bytes_ = new char[length_ + 1];
-    std::memcpy(bytes_, bytes, length_);
-    bytes_[length_] = '\0';
-
+    assign_(bytes, bytes_length);
     return *this;
   }
 
   // Assignment for a string from another string
   ObjString& ObjString::operator=(const ObjString& other)
   {
-    length_ = other.length_;
-
-    delete[] bytes_;
-
-    bytes_ = new char[length_ + 1];
-    std::memcpy(bytes_, other.bytes_, length_);
-    bytes_[length_] = '\0';
-
+    if (this != &other)
+      assign_(other.bytes_, other.length_);
     return *this;
   }
 
   // Destructor for a string
   ObjString::~ObjString()
   {
-    delete[] bytes_;
+    release_();
   }
 
   // Append to the string from a C-string
   ObjString& ObjString::append(const char* bytes)
   {
-    if (!*bytes)
-      return *this;
-
     auto bytes_length = std::strlen(bytes);
-    if (!utf8::is_valid(bytes, bytes + bytes_length))
+    if (!utils::utf8_is_valid(bytes, bytes_length))
       throw StringException("The provided array of bytes is not a valid UTF-8 encoded string");
 
-    size_t pos = length_;
-    bytes_ = (char*)std::realloc(bytes_, length_ + 1);
-    std::memcpy(bytes_ + pos, bytes, length_ - pos);
-    bytes_[length_] = '\0';
-
+    append_(bytes, bytes_length);
     return *this;
   }
 
   // Append to the string from another string
   ObjString& ObjString::append(const ObjString& other)
   {
-    if (other.length_ == 0)
-      return *this;
-
-    size_t pos = length_;
-    bytes_ = (char*)std::realloc(bytes_, length_ + 1);
-    std::memcpy(bytes_ + pos, other.bytes_, length_ - pos);
-    bytes_[length_] = '\0';
-
+    append_(other.bytes_, other.length_);
     return *this;
   }
 
-  // Return the actual characters of the string
+  // Return the actual characters of the string as a C-string, which copies the characters of a slice
   const char* ObjString::c_str()
   {
+    // A slice isn't terminated by a null character, so copy its characters and release the parent
+    if (parent_ != nullptr)
+      assign_(bytes_, length_);
+
     return (const char*)bytes_;
   }
 
+  // Return the actual characters of the string, which are not terminated by a null character for slices
+  const char* ObjString::data()
+  {
+    return (const char*)bytes_;
+  }
+
+  // Return a view over the actual characters of the string
+  string_view_t ObjString::view()
+  {
+    return string_view_t(bytes_, length_);
+  }
+
+  // Return the length in bytes of the string
+  size_t ObjString::byte_length()
+  {
+    return length_;
+  }
+
+  // Return the parent string if the string is a slice, or nullptr otherwise
+  ObjString* ObjString::parent()
+  {
+    return parent_;
+  }
+
+  // Return the byte offset of the code point at the specified position of the string
+  size_t ObjString::offset(size_t pos)
+  {
+    if (pos > rune_length_)
+      throw std::out_of_range(fmt::format("{}", pos));
+
+    // ASCII strings have one byte per code point
+    if (ascii_ || pos == rune_length_)
+      return ascii_ ? pos : length_;
+
+    // Otherwise start at the nearest indexed code point and advance from there
+    if (index_.empty())
+      build_index_();
+
+    char* it = bytes_ + index_[pos / DAUW_STRING_INDEX_STRIDE];
+    for (size_t i = 0; i < pos % DAUW_STRING_INDEX_STRIDE; i ++)
+      utf8::next(it, bytes_ + length_);
+    return it - bytes_;
+  }
+
   // Return the length in code points of the string
   size_t ObjString::length()
   {
-    return utf8::distance(bytes_, bytes_ + length_);
+    return rune_length_;
+  }
+
+  // Return if the string consists of ASCII characters only
+  bool ObjString::ascii()
+  {
+    return ascii_;
   }
 
   // Return the code point at the specified position of the string
   ObjString::value_type ObjString::at(size_t pos)
   {
-    try
-    {
-      char* it = bytes_;
-      utf8::advance(it, pos, bytes_ + length_);
-      return (value_type)*it;
-    }
-    catch (utf8::not_enough_room& ex)
-    {
+    if (pos >= rune_length_)
       throw std::out_of_range(fmt::format("{}", pos));
-    }
+
+    // ASCII strings have one byte per code point
+    if (ascii_)
+      return static_cast<value_type>(bytes_[pos]);
+
+    auto it = bytes_ + offset(pos);
+    return static_cast<value_type>(utf8::peek_next(it, bytes_ + length_));
+  }
+
+  // Return the hash of the string
+  uint32_t ObjString::hash()
+  {
+    return hash_;
   }
 
   // Return an iterator over the code points of the string
@@ -165,4 +210,103 @@ namespace dauw
 
     return 0;
   }
+
+  // Return the number of bytes of heap memory that are owned by the string
+  size_t ObjString::size()
+  {
+    auto heap_bytes = bytes_ != inline_bytes_ && parent_ == nullptr ? length_ + 1 : 0;
+    return sizeof(ObjString) + heap_bytes + index_.capacity() * sizeof(size_t);
+  }
+
+  // Return the hash of an array of bytes using the FNV-1a algorithm
+  uint32_t ObjString::hash(const char* bytes, size_t length)
+  {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i ++)
+    {
+      hash ^= static_cast<uint8_t>(bytes[i]);
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+
+  // Add the parent string of a slice to the list of referenced objects
+  void ObjString::trace(std::vector<Obj*>& objects)
+  {
+    if (parent_ != nullptr)
+      objects.push_back(parent_);
+  }
+
+  // Replace the characters of the string with a copy of an array of bytes, which is stored inline if it fits
+  void ObjString::assign_(const char* bytes, size_t length)
+  {
+    auto new_bytes = length <= DAUW_STRING_INLINE_CAPACITY ? inline_bytes_ : new char[length + 1];
+    std::memmove(new_bytes, bytes, length);
+    new_bytes[length] = '\0';
+
+    release_();
+    bytes_ = new_bytes;
+    length_ = length;
+    update_();
+  }
+
+  // Append a copy of an array of bytes to the characters of the string
+  void ObjString::append_(const char* bytes, size_t length)
+  {
+    if (length == 0)
+      return;
+
+    // Strings that fit inline are stored inline unless they are slices, so the characters only move if the string outgrows the inline buffer
+    auto new_length = length_ + length;
+    if (bytes_ == inline_bytes_ && new_length <= DAUW_STRING_INLINE_CAPACITY)
+      std::memcpy(bytes_ + length_, bytes, length);
+    else
+    {
+      auto new_bytes = new_length <= DAUW_STRING_INLINE_CAPACITY ? inline_bytes_ : new char[new_length + 1];
+      std::memmove(new_bytes, bytes_, length_);
+      std::memcpy(new_bytes + length_, bytes, length);
+
+      release_();
+      bytes_ = new_bytes;
+    }
+
+    length_ = new_length;
+    bytes_[length_] = '\0';
+    update_();
+  }
+
+  // Free the characters of the string if they are owned by the string and not stored inline
+  void ObjString::release_()
+  {
+    if (bytes_ != inline_bytes_ && parent_ == nullptr)
+      delete[] bytes_;
+    bytes_ = inline_bytes_;
+    parent_ = nullptr;
+  }
+
+  // Update the hash, length in code points and ASCII indicator after the characters have changed
+  void ObjString::update_()
+  {
+    hash_ = hash(bytes_, length_);
+
+    // Every code point that is not an ASCII character is encoded in more than one byte
+    rune_length_ = utils::utf8_length(bytes_, length_);
+    ascii_ = rune_length_ == length_;
+
+    index_.clear();
+  }
+
+  // Build the sparse index of a non-ASCII string
+  void ObjString::build_index_()
+  {
+    index_.reserve(rune_length_ / DAUW_STRING_INDEX_STRIDE + 1);
+
+    char* it = bytes_;
+    for (size_t pos = 0; pos < rune_length_; pos ++)
+    {
+      if (pos % DAUW_STRING_INDEX_STRIDE == 0)
+        index_.push_back(it - bytes_);
+      utf8::next(it, bytes_ + length_);
+    }
+  }
 }
@@ -3,12 +3,29 @@
 #include <dauw/common.hpp>
 #include <dauw/internals/object.hpp>
 #include <dauw/internals/value.hpp>
+#include <dauw/utils/string.hpp>
 
 #include <cstdlib>
 #include <cstring>
 #include <utf8.h>
 
 
+// Defines for the number of bytes of a string that are stored inline in the string object instead of in a separate allocation
+#ifndef DAUW_STRING_INLINE_CAPACITY
+  #define DAUW_STRING_INLINE_CAPACITY 22
+#endif
+
+// Defines for the minimal fraction of its parent that a slice must cover to share the buffer of the parent instead of copying
+#ifndef DAUW_STRING_SLICE_MIN_FRACTION
+  #define DAUW_STRING_SLICE_MIN_FRACTION 8
+#endif
+
+// Defines for the sparse index of non-ASCII strings
+#ifndef DAUW_STRING_INDEX_STRIDE
+  #define DAUW_STRING_INDEX_STRIDE 64
+#endif
+
+
 namespace dauw
 {
   class StringException;
@@ -27,9 +44,43 @@ namespace dauw
       // The length of the actual characters of the string
       size_t length_;
 
-      // The actual characters of the string
+      // The actual characters of the string, which point to the inline buffer for short strings or into the buffer of the parent for slices
       char* bytes_;
 
+      // The string whose buffer is shared by the string if it is a slice, or nullptr otherwise
+      ObjString* parent_;
+
+      // The inline buffer for the characters of short strings
+      char inline_bytes_[DAUW_STRING_INLINE_CAPACITY + 1];
+
+      // The hash of the actual characters of the string
+      uint32_t hash_;
+
+      // The length in code points of the string
+      size_t rune_length_;
+
+      // Indicator if the string consists of ASCII characters only
+      bool ascii_;
+
+      // The byte offsets of every DAUW_STRING_INDEX_STRIDE-th code point of a non-ASCII string, built on the first indexed access
+      std::vector<size_t> index_;
+
+
+      // Replace the characters of the string with a copy of an array of bytes, which is stored inline if it fits
+      void assign_(const char* bytes, size_t length);
+
+      // Append a copy of an array of bytes to the characters of the string
+      void append_(const char* bytes, size_t length);
+
+      // Free the characters of the string if they are owned by the string and not stored inline
+      void release_();
+
+      // Update the hash, length in code points and ASCII indicator after the characters have changed
+      void update_();
+
+      // Build the sparse index of a non-ASCII string
+      void build_index_();
+
 
     public:
       // Default constructor
@@ -40,6 +91,9 @@ namespace dauw
       ObjString(const ObjString& other);
       template <typename C> inline ObjString(C c) : ObjString(to_bytes(c)) {}
 
+      // Constructor for a slice that shares the buffer of a parent string, using byte offsets at code point boundaries
+      ObjString(ObjString* parent, size_t offset, size_t length);
+
       ObjString& operator=(const char* bytes);
       ObjString& operator=(const ObjString& other);
       template <typename C> inline ObjString& operator=(C c) { return this->operator=(to_bytes(c)); }
@@ -57,12 +111,33 @@ namespace dauw
       template <typename C> inline ObjString& operator+=(C c) { return append(c); }
 
 
-      // Return the actual characters of the string
+      // Return the actual characters of the string as a C-string, which copies the characters of a slice
       const char* c_str();
 
+      // Return the actual characters of the string, which are not terminated by a null character for slices
+      const char* data();
+
+      // Return a view over the actual characters of the string
+      string_view_t view();
+
+      // Return the length in bytes of the string
+      size_t byte_length();
+
+      // Return the parent string if the string is a slice, or nullptr otherwise
+      ObjString* parent();
+
+      // Return the byte offset of the code point at the specified position of the string
+      size_t offset(size_t pos);
+
       // Return the length in code points of the string
       size_t length();
 
+      // Return if the string consists of ASCII characters only
+      bool ascii();
+
+      // Return the hash of the string
+      uint32_t hash();
+
       // Return the code point at the specified position of the string
       value_type at(size_t pos);
 
@@ -73,6 +148,12 @@ namespace dauw
       // Compare the string to another string
       int compare(ObjString& other);
 
+      // Return the number of bytes of heap memory that are owned by the string
+      virtual size_t size() override;
+
+      // Add the parent string of a slice to the list of referenced objects
+      virtual void trace(std::vector<Obj*>& objects) override;
+
       inline bool operator==(ObjString& other) { return compare(other) == 0; }
       inline bool operator!=(ObjString& other) { return compare(other) != 0; }
       inline bool operator<(ObjString& other) { return compare(other) < 0; }
@@ -81,6 +162,9 @@ namespace dauw
       inline bool operator>=(ObjString& other) { return compare(other) >= 0; }
 
 
+      // Return the hash of an array of bytes
+      static uint32_t hash(const char* bytes, size_t length);
+
       // Convert an iterable of code points to a C-string
       template <typename C>
       static const char* to_bytes(C c)
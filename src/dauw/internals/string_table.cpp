@@ -0,0 +1,85 @@
+#include "string_table.hpp"
+
+namespace dauw
+{
+  // Constructor for a string table
+  StringTable::StringTable()
+    : entries_(DAUW_STRING_TABLE_INITIAL_CAPACITY, nullptr), count_(0)
+  {
+  }
+
+  // Return the entry in which a string with the specified bytes and hash is stored or should be stored
+  ObjString*& StringTable::entry(const char* bytes, size_t length, uint32_t hash)
+  {
+    // The capacity is always a power of two, so the index wraps using a mask
+    auto mask = entries_.size() - 1;
+    for (auto index = hash & mask; ; index = (index + 1) & mask)
+    {
+      auto& entry = entries_[index];
+      if (entry == nullptr)
+        return entry;
+      if (entry->hash() == hash && entry->byte_length() == length && std::memcmp(entry->data(), bytes, length) == 0)
+        return entry;
+    }
+  }
+
+  // Resize the table to the specified capacity and reinsert the strings
+  void StringTable::resize(size_t capacity)
+  {
+    auto entries = std::move(entries_);
+    entries_.assign(capacity, nullptr);
+
+    for (auto string : entries)
+    {
+      if (string != nullptr)
+        entry(string->data(), string->byte_length(), string->hash()) = string;
+    }
+  }
+
+  // Return the number of strings in the table
+  size_t StringTable::count()
+  {
+    return count_;
+  }
+
+  // Return the interned string with the specified bytes and hash, or nullptr if there is none
+  ObjString* StringTable::find(const char* bytes, size_t length, uint32_t hash)
+  {
+    return entry(bytes, length, hash);
+  }
+
+  // Insert a string into the table
+  void StringTable::insert(ObjString* string)
+  {
+    if (count_ + 1 > entries_.size() * DAUW_STRING_TABLE_MAX_LOAD)
+      resize(entries_.size() * 2);
+
+    auto& entry = this->entry(string->data(), string->byte_length(), string->hash());
+    if (entry == nullptr)
+      count_ ++;
+    entry = string;
+  }
+
+  // Remove the strings that are not marked by the garbage collector from the table
+  void StringTable::remove_unmarked()
+  {
+    // Clear the unmarked entries and reinsert the remaining strings, so no probe sequence is interrupted by an empty entry
+    for (auto& entry : entries_)
+    {
+      if (entry != nullptr && !entry->marked())
+      {
+        entry = nullptr;
+        count_ --;
+      }
+    }
+
+    resize(entries_.size());
+  }
+
+  // Remove all strings from the table
+  void StringTable::clear()
+  {
+    entries_.assign(DAUW_STRING_TABLE_INITIAL_CAPACITY, nullptr);
+    count_ = 0;
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <dauw/common.hpp>
+#include <dauw/internals/string_object.hpp>
+
+
+// Defines for the limits of the string table
+#ifndef DAUW_STRING_TABLE_INITIAL_CAPACITY
+  #define DAUW_STRING_TABLE_INITIAL_CAPACITY 64
+#endif
+
+#ifndef DAUW_STRING_TABLE_MAX_LOAD
+  #define DAUW_STRING_TABLE_MAX_LOAD 0.75
+#endif
+
+
+namespace dauw
+{
+  // Class that defines a table of interned strings, which is an open addressing hash set keyed on the bytes of the strings
+  class StringTable
+  {
+    private:
+      // The entries of the table, where an empty entry is nullptr
+      std::vector<ObjString*> entries_;
+
+      // The number of strings in the table
+      size_t count_;
+
+
+      // Return the entry in which a string with the specified bytes and hash is stored or should be stored
+      ObjString*& entry(const char* bytes, size_t length, uint32_t hash);
+
+      // Resize the table to the specified capacity and reinsert the strings
+      void resize(size_t capacity);
+
+
+    public:
+      // Constructor
+      StringTable();
+
+      // Return the number of strings in the table
+      size_t count();
+
+      // Return the interned string with the specified bytes and hash, or nullptr if there is none
+      ObjString* find(const char* bytes, size_t length, uint32_t hash);
+
+      // Insert a string into the table
+      void insert(ObjString* string);
+
+      // Remove the strings that are not marked by the garbage collector from the table
+      void remove_unmarked();
+
+      // Remove all strings from the table
+      void clear();
+  };
+}
@@ -20,6 +20,14 @@ namespace dauw
     : kind_(kind), name_(name), inners_(std::vector<Type>(inners.begin(), inners.end()))
   {
   }
+  Type::Type(TypeKind kind, string_t name, std::vector<Type> inners)
+    : kind_(kind), name_(name), inners_(inners)
+  {
+  }
+  Type::Type(TypeKind kind, string_t name, std::vector<Type> inners, std::vector<string_t> fields)
+    : kind_(kind), name_(name), inners_(inners), fields_(fields)
+  {
+  }
 
   // Return the kind of the type
   TypeKind Type::kind()
@@ -45,13 +53,31 @@ namespace dauw
     return inners_[index];
   }
 
+  // Return the field name of the inner type at the specified index, or an empty string if the inner type is not named
+  string_t Type::field(size_t index)
+  {
+    return index < fields_.size() ? fields_[index] : "";
+  }
+
+  // Return the index of the inner type with the specified field name
+  std::optional<size_t> Type::field_index(string_t name)
+  {
+    for (size_t i = 0; i < fields_.size(); i ++)
+    {
+      if (fields_[i] == name)
+        return i;
+    }
+    return std::nullopt;
+  }
+
   // Return if the type equals another type
-  bool Type::operator==(const Type& other)
+  bool Type::operator==(const Type& other) const
   {
-    // TODO: Add checking of inner types
-    return kind_ == other.kind_ && name_ == other.name_;
+    // Types are only equal if their inner types and field names are equal as well, since the compiler specializes
+    // operations on the types of record fields
+    return kind_ == other.kind_ && name_ == other.name_ && inners_ == other.inners_ && fields_ == other.fields_;
   }
-  bool Type::operator!=(const Type& other)
+  bool Type::operator!=(const Type& other) const
   {
     return !(*this == other);
   }
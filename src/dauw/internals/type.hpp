@@ -34,10 +34,15 @@ namespace dauw
       // The inner types of the type
       std::vector<Type> inners_;
 
+      // The field names of the inner types of the type, if the type is a record type with known fields
+      std::vector<string_t> fields_;
+
 
     public:
       // Constructor
       Type(TypeKind kind, string_t name, std::initializer_list<Type> inners = {});
+      Type(TypeKind kind, string_t name, std::vector<Type> inners);
+      Type(TypeKind kind, string_t name, std::vector<Type> inners, std::vector<string_t> fields);
 
       // Return the kind of the type
       TypeKind kind();
@@ -51,9 +56,15 @@ namespace dauw
       // Return the inner type of the type at the specified index
       Type inner(size_t index);
 
+      // Return the field name of the inner type at the specified index, or an empty string if the inner type is not named
+      string_t field(size_t index);
+
+      // Return the index of the inner type with the specified field name
+      std::optional<size_t> field_index(string_t name);
+
       // Return if the type equals another type
-      bool operator==(const Type& other);
-      bool operator!=(const Type& other);
+      bool operator==(const Type& other) const;
+      bool operator!=(const Type& other) const;
 
 
       // Definitions for global types
@@ -89,6 +100,8 @@ namespace fmt
         {
           if (i > 0)
             format += ", ";
+          if (!type.field(i).empty())
+            format += fmt::format("{}: ", type.field(i));
           format += fmt::format("{}", type.inner(i));
         }
         format += "]";
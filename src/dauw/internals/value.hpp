@@ -6,6 +6,8 @@
 #include <dauw/internals/type.hpp>
 #include <dauw/utils/string.hpp>
 
+#include <cstring>
+
 
 // Type definition for the value type
 using value_t = uint64_t;
@@ -72,6 +74,9 @@ namespace dauw
       bool is_int() const;
       dauw_int_t as_int() const;
 
+      // Convert a value to an int type without checking the type, which must be guaranteed by the caller
+      inline dauw_int_t as_int_unchecked() const { return static_cast<dauw_int_t>(value_ << 16) >> 16; }
+
       // Value that represents a rune type
       static Value of_rune(dauw_rune_t rune_value);
       bool is_rune() const;
@@ -83,6 +88,9 @@ namespace dauw
       bool is_nan() const;
       dauw_float_t as_float() const;
 
+      // Convert a value to a float type without checking the type, which must be guaranteed by the caller
+      inline dauw_float_t as_float_unchecked() const { dauw_float_t float_value; std::memcpy(&float_value, &value_, sizeof(float_value)); return float_value; }
+
       // Value that represents an object type
       static Value of_obj(Obj* object_value);
       bool is_obj() const;
@@ -57,4 +57,94 @@ namespace dauw::debug
       }
     }
   }
+
+  // Print the disassembled instructions of a chunk
+  void print_chunk(Chunk& chunk, string_t name)
+  {
+    fmt::print(fmt::fg(fmt::color::light_green), "== {} ==\n", name);
+
+    size_t offset = 0;
+    while (offset < chunk.size())
+    {
+      auto op = static_cast<OpCode>(chunk.code()[offset]);
+      fmt::print("{:04d} {:<16}", offset, op);
+
+      // Print the operands of the instruction
+      switch (op)
+      {
+        case OpCode::CONSTANT:
+          fmt::print(" {:5d} ({})\n", chunk.read_u16(offset + 1), format(chunk.constants()[chunk.read_u16(offset + 1)], true));
+          offset += 3;
+          break;
+
+        case OpCode::GET_GLOBAL:
+        case OpCode::DEFINE_GLOBAL:
+        case OpCode::SEQUENCE:
+        case OpCode::CONCAT:
+          fmt::print(" {:5d}\n", chunk.read_u16(offset + 1));
+          offset += 3;
+          break;
+
+        case OpCode::RECORD:
+          fmt::print(" {:5d} ({})\n", chunk.read_u16(offset + 1), fmt::join(chunk.shapes()[chunk.read_u16(offset + 1)]->names(), ", "));
+          offset += 3;
+          break;
+
+        case OpCode::GET_FIELD:
+          fmt::print(" {:5d} ({})\n", chunk.read_u16(offset + 1), chunk.field_caches()[chunk.read_u16(offset + 1)].name);
+          offset += 3;
+          break;
+
+        case OpCode::JUMP:
+        case OpCode::JUMP_IF_FALSE:
+        case OpCode::JUMP_IF_TRUE:
+          fmt::print(" {:5d} -> {:04d}\n", chunk.read_u16(offset + 1), offset + 3 + chunk.read_u16(offset + 1));
+          offset += 3;
+          break;
+
+        case OpCode::LOOP:
+          fmt::print(" {:5d} -> {:04d}\n", chunk.read_u16(offset + 1), offset + 3 - chunk.read_u16(offset + 1));
+          offset += 3;
+          break;
+
+        case OpCode::CLOSE_SCOPE:
+        case OpCode::GET_LOCAL:
+        case OpCode::CALL:
+          fmt::print(" {:5d}\n", chunk.code()[offset + 1]);
+          offset += 2;
+          break;
+
+        case OpCode::ADD_INT_LL:
+        case OpCode::SUBTRACT_INT_LL:
+        case OpCode::MULTIPLY_INT_LL:
+        case OpCode::LESS_INT_LL:
+        case OpCode::LESS_EQUAL_INT_LL:
+        case OpCode::GREATER_INT_LL:
+        case OpCode::GREATER_EQUAL_INT_LL:
+        case OpCode::EQUAL_INT_LL:
+        case OpCode::NOT_EQUAL_INT_LL:
+          fmt::print(" {:5d} {:5d}\n", chunk.code()[offset + 1], chunk.code()[offset + 2]);
+          offset += 3;
+          break;
+
+        case OpCode::ADD_INT_LC:
+        case OpCode::SUBTRACT_INT_LC:
+        case OpCode::MULTIPLY_INT_LC:
+        case OpCode::LESS_INT_LC:
+        case OpCode::LESS_EQUAL_INT_LC:
+        case OpCode::GREATER_INT_LC:
+        case OpCode::GREATER_EQUAL_INT_LC:
+        case OpCode::EQUAL_INT_LC:
+        case OpCode::NOT_EQUAL_INT_LC:
+          fmt::print(" {:5d} {:5d} ({})\n", chunk.code()[offset + 1], chunk.read_u16(offset + 2), format(chunk.constants()[chunk.read_u16(offset + 2)], true));
+          offset += 4;
+          break;
+
+        default:
+          fmt::print("\n");
+          offset += 1;
+          break;
+      }
+    }
+  }
 }
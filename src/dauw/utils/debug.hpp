@@ -1,8 +1,10 @@
 #pragma once
 
 #include <dauw/common.hpp>
+#include <dauw/backend/chunk.hpp>
 #include <dauw/frontend/lexer.hpp>
 #include <dauw/frontend/token.hpp>
+#include <dauw/internals/format.hpp>
 #include <dauw/utils/string.hpp>
 
 
@@ -13,4 +15,7 @@ namespace dauw::debug
 
   // Print a list of tokens
   void print_tokens(Lexer::token_list_type tokens);
+
+  // Print the disassembled instructions of a chunk
+  void print_chunk(Chunk& chunk, string_t name);
 }
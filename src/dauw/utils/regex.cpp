@@ -30,6 +30,8 @@ namespace dauw::utils
       flags |= PCRE2_ANCHORED;
     if ((match_flags & REGEX_MATCH_AT_END) == REGEX_MATCH_AT_END)
       flags |= PCRE2_ENDANCHORED;
+    if ((match_flags & REGEX_MATCH_NO_UTF_CHECK) == REGEX_MATCH_NO_UTF_CHECK)
+      flags |= PCRE2_NO_UTF_CHECK;
 
     return flags;
   }
@@ -42,20 +44,16 @@ namespace dauw::utils
     return string_t((char*)buffer);
   }
 
-  // Constructor for a regular expression
-  Regex::Regex(string_t pattern, RegexFlags flags)
-    : pattern_(pattern)
+  // Compile the pattern using the JIT compiler if available and index the named groups
+  void Regex::prepare_()
   {
-    // Create the pattern
-    auto p_str = (char_type*)pattern_.c_str();
-    auto p_length = pattern_.length();
-    auto options = pcre2_options_(flags);
+    // Compile the pattern to machine code; if the JIT compiler is not available, then matching falls back to the interpreter
+    jit_ = pcre2_jit_compile(code_, PCRE2_JIT_COMPLETE) == 0;
 
-    int result;
-    size_t offset;
-    code_ = pcre2_compile(p_str, p_length, options, &result, &offset, nullptr);
-    if (code_ == nullptr)
-      throw RegexException(fmt::format("Cannot compile pattern '{}' at offset {}: {}", pattern_, offset, pcre2_error_(result)));
+    // Fetch the number of capture groups of the pattern
+    uint32_t capture_count;
+    pcre2_pattern_info(code_, PCRE2_INFO_CAPTURECOUNT, &capture_count);
+    group_count_ = capture_count + 1;
 
     // Create the named groups index of the pattern
     uint32_t name_count, name_entry_size;
@@ -65,16 +63,53 @@ namespace dauw::utils
     pcre2_pattern_info(code_, PCRE2_INFO_NAMEENTRYSIZE, &name_entry_size);
     pcre2_pattern_info(code_, PCRE2_INFO_NAMETABLE, &name_table);
 
+    indexes_.clear();
     char_type* name_table_ptr = name_table;
     for (auto i = 0; i < name_count; i++)
     {
       size_t group = (name_table_ptr[0] << 8) | name_table_ptr[1];
-      string_t name = string_t(name_table_ptr + 2, name_table_ptr + name_entry_size);
+      string_t name = string_t((char*)name_table_ptr + 2);
       indexes_[name] = group;
       name_table_ptr += name_entry_size;
     }
   }
 
+  // Perform a match using the match data of the current thread and return the PCRE2 result code
+  int Regex::pcre2_match_(string_view_t subject, size_t pos, RegexMatchFlags flags, match_type& match)
+  {
+    auto& context = RegexMatchContext::current();
+    match = context.match_data(group_count_);
+
+    auto s_str = subject.data() != nullptr ? (char_type*)subject.data() : (char_type*)"";
+    auto s_length = subject.length();
+    auto options = pcre2_options_(flags);
+
+    int result = pcre2_match(code_, s_str, s_length, pos, options, match, context.match_context());
+    if (result < 0 && result != PCRE2_ERROR_NOMATCH)
+      throw RegexException(fmt::format("Cannot match pattern '{}': {}", pattern_, pcre2_error_(result)));
+
+    return result;
+  }
+
+  // Constructor for a regular expression
+  Regex::Regex(string_t pattern, RegexFlags flags)
+    : pattern_(pattern)
+  {
+    // Create the pattern
+    auto p_str = (char_type*)pattern_.c_str();
+    auto p_length = pattern_.length();
+    auto options = pcre2_options_(flags);
+
+    int result;
+    size_t offset;
+    code_ = pcre2_compile(p_str, p_length, options, &result, &offset, nullptr);
+    if (code_ == nullptr)
+      throw RegexException(fmt::format("Cannot compile pattern '{}' at offset {}: {}", pattern_, offset, pcre2_error_(result)));
+
+    // Prepare the compiled pattern
+    prepare_();
+  }
+
   // Copy constructor for a regular expression
   Regex::Regex(const Regex& other)
     : pattern_(other.pattern_)
@@ -83,6 +118,9 @@ namespace dauw::utils
     code_ = pcre2_code_copy(other.code_);
     if (code_ == nullptr)
       throw RegexException(fmt::format("Cannot copy pattern '{}'", pattern_));
+
+    // Prepare the copied pattern, since the JIT-compiled code is not copied along with it
+    prepare_();
   }
 
   // Destructor for a regular expression
@@ -107,45 +145,66 @@ namespace dauw::utils
       throw RegexException(fmt::format("Cannot find named capture group '{}' in pattern '{}'", name, pattern_));
   }
 
+  // Return the number of capture groups of the pattern, including the group of the whole match
+  size_t Regex::group_count()
+  {
+    return group_count_;
+  }
+
+  // Return if the pattern has been compiled by the JIT compiler
+  bool Regex::jit()
+  {
+    return jit_;
+  }
+
   // Search for the regular expression in a string
-  RegexMatch Regex::match(string_t subject, size_t pos, RegexMatchFlags flags)
+  RegexMatch Regex::match(string_view_t subject, size_t pos, RegexMatchFlags flags)
   {
     // Perform the match
-    auto s_str = (char_type*)subject.c_str();
-    auto s_length = subject.length();
-    auto options = pcre2_options_(flags);
+    match_type match;
+    int result = pcre2_match_(subject, pos, flags, match);
 
-    auto match = pcre2_match_data_create_from_pattern(code_, nullptr);
-    int error = pcre2_match(code_, s_str, s_length, pos, options, match, nullptr);
-    if (error < 0)
+    // Fetch the offsets of the groups of the match
+    std::vector<size_t> offsets;
+    if (result > 0)
     {
-      // Throw an error in any case except having found no match
-      if (error != PCRE2_ERROR_NOMATCH)
-        throw RegexException(fmt::format("Cannot match pattern: {}", pcre2_error_(error)));
+      auto ovector = pcre2_get_ovector_pointer(match);
+      offsets.assign(ovector, ovector + 2 * result);
     }
 
-    // Fetch the groups of the match
-    std::vector<RegexGroup> groups;
-    if (error != PCRE2_ERROR_NOMATCH)
+    // Create and return the result
+    return RegexMatch(this, subject, std::move(offsets));
+  }
+
+  // Search for the regular expression in a string and store the start and end offsets of the groups in the offsets array
+  size_t Regex::match(string_view_t subject, size_t* offsets, size_t offsets_count, size_t pos, RegexMatchFlags flags)
+  {
+    // Perform the match
+    match_type match;
+    int result = pcre2_match_(subject, pos, flags, match);
+    if (result <= 0)
+      return 0;
+    auto group_count = static_cast<size_t>(result);
+
+    // Copy the offsets of the groups of the match
+    auto ovector = pcre2_get_ovector_pointer(match);
+    for (size_t i = 0; i < offsets_count; i ++)
     {
-      auto ovector = pcre2_get_ovector_pointer(match);
-      for (auto i = 0; i < error; i ++)
-      {
-        size_t start = ovector[2 * i];
-        size_t end = ovector[2 * i + 1];
-        bool success = start != PCRE2_UNSET && end != PCRE2_UNSET;
-        groups.push_back(RegexGroup(this, subject, start, end));
-      }
+      offsets[2 * i] = i < group_count ? ovector[2 * i] : PCRE2_UNSET;
+      offsets[2 * i + 1] = i < group_count ? ovector[2 * i + 1] : PCRE2_UNSET;
     }
+    return group_count;
+  }
 
-    // Create and return the result
-    RegexMatch result(this, subject, groups);
-    pcre2_match_data_free(match);
-    return result;
+  // Return if the regular expression matches anywhere in a string
+  bool Regex::matches(string_view_t subject)
+  {
+    match_type match;
+    return pcre2_match_(subject, 0, REGEX_MATCH_NONE, match) > 0;
   }
 
   // Search for all non-overlapping occurrences of the regular expression in a string
-  std::vector<RegexMatch> Regex::match_all(string_t subject, size_t pos)
+  std::vector<RegexMatch> Regex::match_all(string_view_t subject, size_t pos)
   {
     std::vector<RegexMatch> matches;
 
@@ -161,12 +220,12 @@ namespace dauw::utils
   }
 
   // Substitute all non-overlapping occurrences of the regular expression in a string
-  string_t Regex::substitute(string_t subject, string_t replacement)
+  string_t Regex::substitute(string_view_t subject, string_view_t replacement)
   {
     // Perform the substitution
-    auto s_str = (char_type*)subject.c_str();
+    auto s_str = (char_type*)subject.data();
     auto s_length = subject.length();
-    auto r_str = (char_type*)replacement.c_str();
+    auto r_str = (char_type*)replacement.data();
     auto r_length = replacement.length();
     auto options = PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH;
 
@@ -196,29 +255,97 @@ namespace dauw::utils
   }
 
   // Split a string by the occurrences of the regular expression
-  std::vector<string_t> Regex::split(string_t subject)
+  std::vector<string_t> Regex::split(string_view_t subject)
   {
-    auto m = match(subject);
-    if (!m.success())
-      return std::vector<string_t>({subject});
+    size_t offsets[2];
+    if (match(subject, offsets, 1) == 0)
+      return std::vector<string_t>({string_t(subject)});
 
     std::vector<string_t> parts;
 
     size_t pos = 0;
-    while (m.success())
+    do
     {
-      parts.push_back(string_t(subject, pos, m.start() - pos));
-      pos = m.end();
-      m = match(subject, pos);
-    }
+      parts.push_back(string_t(subject.substr(pos, offsets[0] - pos)));
+      pos = offsets[1];
+    } while (match(subject, offsets, 1, pos) > 0);
 
     return parts;
   }
 
+  // Return a compiled regular expression for a pattern from the pattern cache of the current thread
+  Regex& Regex::cached(string_t pattern)
+  {
+    thread_local std::unordered_map<string_t, std::unique_ptr<Regex>> cache;
+
+    auto it = cache.find(pattern);
+    if (it != cache.end())
+      return *it->second;
+
+    // Drop all cached patterns if the cache is full
+    if (cache.size() >= DAUW_REGEX_CACHE_MAX)
+      cache.clear();
+
+    auto regex = std::make_unique<Regex>(pattern);
+    return *cache.emplace(pattern, std::move(regex)).first->second;
+  }
+
+  // --------------------------------------------------------------------------
+
+  // Constructor for a match context
+  RegexMatchContext::RegexMatchContext()
+    : match_data_(nullptr), match_data_size_(0)
+  {
+    match_context_ = pcre2_match_context_create(nullptr);
+    jit_stack_ = pcre2_jit_stack_create(DAUW_REGEX_JIT_STACK_START, DAUW_REGEX_JIT_STACK_MAX, nullptr);
+    if (jit_stack_ != nullptr)
+      pcre2_jit_stack_assign(match_context_, nullptr, jit_stack_);
+  }
+
+  // Destructor for a match context
+  RegexMatchContext::~RegexMatchContext()
+  {
+    if (match_data_ != nullptr)
+      pcre2_match_data_free(match_data_);
+    if (jit_stack_ != nullptr)
+      pcre2_jit_stack_free(jit_stack_);
+    pcre2_match_context_free(match_context_);
+  }
+
+  // Return match data that can hold at least the specified number of groups
+  pcre2_match_data* RegexMatchContext::match_data(size_t group_count)
+  {
+    if (group_count > match_data_size_)
+    {
+      if (match_data_ != nullptr)
+        pcre2_match_data_free(match_data_);
+
+      match_data_size_ = std::max(static_cast<uint32_t>(group_count), std::max(match_data_size_ * 2, 16u));
+      match_data_ = pcre2_match_data_create(match_data_size_, nullptr);
+      if (match_data_ == nullptr)
+        throw RegexException("Cannot allocate match data");
+    }
+
+    return match_data_;
+  }
+
+  // Return the match context
+  pcre2_match_context* RegexMatchContext::match_context()
+  {
+    return match_context_;
+  }
+
+  // Return the context of the current thread
+  RegexMatchContext& RegexMatchContext::current()
+  {
+    thread_local RegexMatchContext context;
+    return context;
+  }
+
   // --------------------------------------------------------------------------
 
   // Constructor
-  RegexGroup::RegexGroup(Regex* pattern, string_t subject, size_t start, size_t end)
+  RegexGroup::RegexGroup(Regex* pattern, string_view_t subject, size_t start, size_t end)
     : pattern_(pattern), subject_(subject), start_(start), end_(end)
   {
   }
@@ -229,8 +356,8 @@ namespace dauw::utils
     return pattern_;
   }
 
-  // Return the subject of the capture group
-  string_t RegexGroup::subject()
+  // Return a view of the subject of the capture group
+  string_view_t RegexGroup::subject()
   {
     return subject_;
   }
@@ -259,17 +386,23 @@ namespace dauw::utils
     return end_ - start_;
   }
 
-  // Return the substring matched by a capture group
+  // Return a view of the substring matched by the capture group
+  string_view_t RegexGroup::view()
+  {
+    return success() ? subject_.substr(start_, end_ - start_) : string_view_t();
+  }
+
+  // Return a copy of the substring matched by the capture group
   string_t RegexGroup::value()
   {
-    return success() ? string_t(subject_, start_, end_ - start_) : "";
+    return string_t(view());
   }
 
   // --------------------------------------------------------------------------
 
   // Constructor for a regular expression match
-  RegexMatch::RegexMatch(Regex* pattern, string_t subject, std::vector<RegexGroup> groups)
-    : pattern_(pattern), subject_(subject), groups_(groups)
+  RegexMatch::RegexMatch(Regex* pattern, string_view_t subject, std::vector<size_t> offsets)
+    : pattern_(pattern), subject_(subject), offsets_(std::move(offsets))
   {
   }
 
@@ -279,23 +412,29 @@ namespace dauw::utils
     return pattern_;
   }
 
-  // Return the subject of the regular expression match
-  string_t RegexMatch::subject()
+  // Return a view of the subject of the regular expression match
+  string_view_t RegexMatch::subject()
   {
     return subject_;
   }
 
+  // Return the number of capture groups of the regular expression match
+  size_t RegexMatch::group_count()
+  {
+    return offsets_.size() / 2;
+  }
+
   // Return if the regular expression match has matched anything
   bool RegexMatch::success()
   {
-    return groups_.size() > 0;
+    return offsets_.size() > 0;
   }
 
   // Return a numbered capture group of the regular expression match
   RegexGroup RegexMatch::group(int index)
   {
-    if (index < groups_.size())
-      return groups_[index];
+    if (index >= 0 && static_cast<size_t>(index) < group_count())
+      return RegexGroup(pattern_, subject_, offsets_[2 * index], offsets_[2 * index + 1]);
     else
       throw RegexException(fmt::format("Cannot find capture group {} in pattern", index));
   }
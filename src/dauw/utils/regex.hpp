@@ -5,10 +5,18 @@
 #include <pcre2.h>
 
 
+// Defines for the sizes of the JIT stack of a thread
+#define DAUW_REGEX_JIT_STACK_START (32 * 1024)
+#define DAUW_REGEX_JIT_STACK_MAX (512 * 1024)
+
+// Define for the maximal number of compiled patterns in the pattern cache of a thread
+#define DAUW_REGEX_CACHE_MAX 256
+
 namespace dauw::utils
 {
   // Forward declarations
   class Regex;
+  class RegexMatchContext;
   class RegexMatch;
   class RegexGroup;
   class RegexException;
@@ -28,9 +36,10 @@ namespace dauw::utils
   // Enum that defines flags for a regular expression match
   enum RegexMatchFlags : int
   {
-    REGEX_MATCH_NONE      = 0,
-    REGEX_MATCH_AT_BEGIN  = 1 << 1,   // Pattern can match only at the beginning of the subject string
-    REGEX_MATCH_AT_END    = 1 << 2,   // Pattern can match only at the end of the subject string
+    REGEX_MATCH_NONE          = 0,
+    REGEX_MATCH_AT_BEGIN      = 1 << 1,   // Pattern can match only at the beginning of the subject string
+    REGEX_MATCH_AT_END        = 1 << 2,   // Pattern can match only at the end of the subject string
+    REGEX_MATCH_NO_UTF_CHECK  = 1 << 3,   // Subject string is known to be valid UTF-8, so its encoding is not checked
   };
 
 
@@ -55,6 +64,18 @@ namespace dauw::utils
       // The compiled PCRE2 pattern of the regular expression
       pattern_type code_;
 
+      // Indicate if the pattern has been compiled by the PCRE2 JIT compiler
+      bool jit_;
+
+      // The number of capture groups of the pattern, including the group of the whole match
+      size_t group_count_;
+
+
+      // Compile the pattern using the JIT compiler if available and index the named groups
+      void prepare_();
+
+      // Perform a match using the match data of the current thread and return the PCRE2 result code
+      int pcre2_match_(string_view_t subject, size_t pos, RegexMatchFlags flags, match_type& match);
 
       // Convert pattern and match flags to PCRE2 options
       static options_type pcre2_options_(RegexFlags pattern_flags);
@@ -80,17 +101,72 @@ namespace dauw::utils
       // Return the index of the numbered group corresponding to a named group
       size_t index(string_t name);
 
-      // Search for the regular expression in a string
-      RegexMatch match(string_t subject, size_t pos = 0, RegexMatchFlags flags = REGEX_MATCH_NONE);
+      // Return the number of capture groups of the pattern, including the group of the whole match
+      size_t group_count();
+
+      // Return if the pattern has been compiled by the JIT compiler
+      bool jit();
+
+      // Search for the regular expression in a string; the match refers to the subject, so the subject must outlive it
+      RegexMatch match(string_view_t subject, size_t pos = 0, RegexMatchFlags flags = REGEX_MATCH_NONE);
+
+      // Search for the regular expression in a string and store the start and end offsets of at most the specified number of groups in the offsets array, which must hold twice that number of elements; return the number of groups of the match, or zero if there was no match
+      size_t match(string_view_t subject, size_t* offsets, size_t offsets_count, size_t pos = 0, RegexMatchFlags flags = REGEX_MATCH_NONE);
+
+      // Return if the regular expression matches anywhere in a string
+      bool matches(string_view_t subject);
 
       // Search for all non-overlapping occurrences of the regular expression in a string
-      std::vector<RegexMatch> match_all(string_t subject, size_t pos = 0);
+      std::vector<RegexMatch> match_all(string_view_t subject, size_t pos = 0);
 
       // Substitute all non-overlapping occurrences of the regular expression in a string
-      string_t substitute(string_t subject, string_t replacement);
+      string_t substitute(string_view_t subject, string_view_t replacement);
 
       // Split a string by the occurrences of the regular expression
-      std::vector<string_t> split(string_t subject);
+      std::vector<string_t> split(string_view_t subject);
+
+
+      // Return a compiled regular expression for a pattern from the pattern cache of the current thread
+      static Regex& cached(string_t pattern);
+  };
+
+
+  // Class that defines the match resources that are reused by all matches in a thread
+  class RegexMatchContext
+  {
+    private:
+      // The match data that receives the offsets of the capture groups
+      pcre2_match_data* match_data_;
+
+      // The number of groups the match data can hold
+      uint32_t match_data_size_;
+
+      // The match context that refers to the JIT stack
+      pcre2_match_context* match_context_;
+
+      // The stack used by JIT-compiled patterns
+      pcre2_jit_stack* jit_stack_;
+
+
+    public:
+      // Constructor
+      RegexMatchContext();
+
+      // Destructor
+      ~RegexMatchContext();
+
+      // Disable copying of the context
+      RegexMatchContext(const RegexMatchContext& other) = delete;
+      RegexMatchContext& operator=(const RegexMatchContext& other) = delete;
+
+      // Return match data that can hold at least the specified number of groups
+      pcre2_match_data* match_data(size_t group_count);
+
+      // Return the match context
+      pcre2_match_context* match_context();
+
+      // Return the context of the current thread
+      static RegexMatchContext& current();
   };
 
 
@@ -101,8 +177,8 @@ namespace dauw::utils
       // The regular expression of the capture group
       Regex* pattern_;
 
-      // The subject of the capture group
-      string_t subject_;
+      // A view of the subject of the capture group
+      string_view_t subject_;
 
       // The start offset of the substring matched by the capture group
       size_t start_;
@@ -113,13 +189,13 @@ namespace dauw::utils
 
     public:
       // Constructor
-      RegexGroup(Regex* pattern, string_t subject, size_t start, size_t end);
+      RegexGroup(Regex* pattern, string_view_t subject, size_t start, size_t end);
 
       // Return the regular expression of the capture group
       Regex* pattern();
 
-      // Return the subject of the capture group
-      string_t subject();
+      // Return a view of the subject of the capture group
+      string_view_t subject();
 
       // Return if the capture group has matched anything
       bool success();
@@ -128,6 +204,11 @@ namespace dauw::utils
       size_t start();
       size_t end();
       size_t length();
+
+      // Return a view of the substring matched by the capture group
+      string_view_t view();
+
+      // Return a copy of the substring matched by the capture group
       string_t value();
   };
 
@@ -139,22 +220,25 @@ namespace dauw::utils
       // The regular expression of the regular expression match
       Regex* pattern_;
 
-      // The subject of the regular expression match
-      string_t subject_;
+      // A view of the subject of the regular expression match
+      string_view_t subject_;
 
-      // The capture groups of the regular expression match
-      std::vector<RegexGroup> groups_;
+      // The start and end offsets of the capture groups of the regular expression match
+      std::vector<size_t> offsets_;
 
 
     public:
       // Constructor
-      RegexMatch(Regex* pattern, string_t subject, std::vector<RegexGroup> groups);
+      RegexMatch(Regex* pattern, string_view_t subject, std::vector<size_t> offsets);
 
       // Return the regular expression of the regular expression match
       Regex* pattern();
 
-      // Return the subject of the regular expression match
-      string_t subject();
+      // Return a view of the subject of the regular expression match
+      string_view_t subject();
+
+      // Return the number of capture groups of the regular expression match
+      size_t group_count();
 
       // Return if the regular expression match has matched anything
       bool success();
@@ -171,6 +255,7 @@ namespace dauw::utils
       inline size_t start() { return group().start(); }
       inline size_t end() { return group().end(); }
       inline size_t length() { return group().length(); }
+      inline string_view_t view() { return group().view(); }
       inline string_t value() { return group().value(); }
   };
 
@@ -2,8 +2,303 @@
 
 #include <dauw/utils/regex.hpp>
 
+
+// Defines for the vectorized implementations of the UTF-8 functions, which are selected at runtime based on the features of the CPU
+#if !defined(DAUW_NO_SIMD) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  #define DAUW_SIMD_X86
+  #include <immintrin.h>
+#endif
+
+
 namespace dauw::utils
 {
+  // Validate a UTF-8 encoded string from the specified position using the scalar implementation
+  static bool utf8_is_valid_scalar(const uint8_t* bytes, size_t length, size_t& pos)
+  {
+    auto valid = utf8::is_valid(bytes + pos, bytes + length);
+    pos = length;
+    return valid;
+  }
+
+  // Count the code points in a valid UTF-8 encoded string from the specified position using the scalar implementation
+  static size_t utf8_length_scalar(const uint8_t* bytes, size_t length, size_t& pos)
+  {
+    size_t count = 0;
+    for (; pos < length; pos ++)
+    {
+      if ((bytes[pos] & 0xc0) != 0x80)
+        count ++;
+    }
+    return count;
+  }
+
+#ifdef DAUW_SIMD_X86
+  // Error classes of the UTF-8 validation algorithm by Keiser and Lemire, which are looked up by the high and low
+  // nibble of a byte and the high nibble of the byte that follows it
+  static constexpr uint8_t UTF8_TOO_SHORT = 1 << 0;
+  static constexpr uint8_t UTF8_TOO_LONG = 1 << 1;
+  static constexpr uint8_t UTF8_OVERLONG_3 = 1 << 2;
+  static constexpr uint8_t UTF8_TOO_LARGE = 1 << 3;
+  static constexpr uint8_t UTF8_SURROGATE = 1 << 4;
+  static constexpr uint8_t UTF8_OVERLONG_2 = 1 << 5;
+  static constexpr uint8_t UTF8_TOO_LARGE_1000 = 1 << 6;
+  static constexpr uint8_t UTF8_OVERLONG_4 = 1 << 6;
+  static constexpr uint8_t UTF8_TWO_CONTS = 1 << 7;
+  static constexpr uint8_t UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS;
+
+  // Lookup table for the high nibble of the first byte
+  alignas(16) static const uint8_t utf8_byte_1_high_table[16] = {
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+  };
+
+  // Lookup table for the low nibble of the first byte
+  alignas(16) static const uint8_t utf8_byte_1_low_table[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+  };
+
+  // Lookup table for the high nibble of the second byte
+  alignas(16) static const uint8_t utf8_byte_2_high_table[16] = {
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+  };
+
+  // Validate the 16-byte blocks of a UTF-8 encoded string from the specified position using SSE4.2 instructions
+  __attribute__((target("sse4.2")))
+  static bool utf8_is_valid_sse42(const uint8_t* bytes, size_t length, size_t& pos)
+  {
+    auto byte_1_high_table = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high_table));
+    auto byte_1_low_table = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low_table));
+    auto byte_2_high_table = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high_table));
+    auto nibble_mask = _mm_set1_epi8(0x0f);
+
+    auto error = _mm_setzero_si128();
+    auto previous = _mm_setzero_si128();
+    for (; pos + 16 <= length; pos += 16)
+    {
+      auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+
+      // A block of ASCII characters is valid if the previous block didn't end in the middle of a code point
+      if (_mm_movemask_epi8(input) == 0 && (_mm_movemask_epi8(previous) & 0xe000) == 0)
+      {
+        previous = input;
+        continue;
+      }
+
+      // Check every byte against the bytes before it
+      auto prev1 = _mm_alignr_epi8(input, previous, 15);
+      auto prev2 = _mm_alignr_epi8(input, previous, 14);
+      auto prev3 = _mm_alignr_epi8(input, previous, 13);
+
+      auto byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble_mask));
+      auto byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, nibble_mask));
+      auto byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), nibble_mask));
+      auto special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+      auto is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+      auto is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+      auto must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8(static_cast<char>(0x80)));
+
+      error = _mm_or_si128(error, _mm_xor_si128(must_be_continuation, special_cases));
+      previous = input;
+    }
+
+    return _mm_testz_si128(error, error);
+  }
+
+  // Validate the 32-byte blocks of a UTF-8 encoded string from the specified position using AVX2 instructions
+  __attribute__((target("avx2")))
+  static bool utf8_is_valid_avx2(const uint8_t* bytes, size_t length, size_t& pos)
+  {
+    auto byte_1_high_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high_table)));
+    auto byte_1_low_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low_table)));
+    auto byte_2_high_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high_table)));
+    auto nibble_mask = _mm256_set1_epi8(0x0f);
+
+    auto error = _mm256_setzero_si256();
+    auto previous = _mm256_setzero_si256();
+    for (; pos + 32 <= length; pos += 32)
+    {
+      auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos));
+
+      // A block of ASCII characters is valid if the previous block didn't end in the middle of a code point
+      if (_mm256_movemask_epi8(input) == 0 && (static_cast<uint32_t>(_mm256_movemask_epi8(previous)) & 0xe0000000u) == 0)
+      {
+        previous = input;
+        continue;
+      }
+
+      // Check every byte against the bytes before it, which crosses the 128-bit lanes of the registers
+      auto shifted = _mm256_permute2x128_si256(previous, input, 0x21);
+      auto prev1 = _mm256_alignr_epi8(input, shifted, 15);
+      auto prev2 = _mm256_alignr_epi8(input, shifted, 14);
+      auto prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+      auto byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble_mask));
+      auto byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, nibble_mask));
+      auto byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble_mask));
+      auto special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+      auto is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+      auto is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+      auto must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+      error = _mm256_or_si256(error, _mm256_xor_si256(must_be_continuation, special_cases));
+      previous = input;
+    }
+
+    return _mm256_testz_si256(error, error);
+  }
+
+  // Count the code points in the 16-byte blocks of a valid UTF-8 encoded string from the specified position using SSE4.2 instructions
+  __attribute__((target("sse4.2,popcnt")))
+  static size_t utf8_length_sse42(const uint8_t* bytes, size_t length, size_t& pos)
+  {
+    // Every byte except a continuation byte, which is less than -64 as a signed byte, starts a code point
+    auto continuation_max = _mm_set1_epi8(-65);
+
+    size_t count = 0;
+    for (; pos + 16 <= length; pos += 16)
+    {
+      auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+      count += _mm_popcnt_u32(_mm_movemask_epi8(_mm_cmpgt_epi8(input, continuation_max)));
+    }
+    return count;
+  }
+
+  // Count the code points in the 32-byte blocks of a valid UTF-8 encoded string from the specified position using AVX2 instructions
+  __attribute__((target("avx2,popcnt")))
+  static size_t utf8_length_avx2(const uint8_t* bytes, size_t length, size_t& pos)
+  {
+    // Every byte except a continuation byte, which is less than -64 as a signed byte, starts a code point
+    auto continuation_max = _mm256_set1_epi8(-65);
+
+    size_t count = 0;
+    for (; pos + 32 <= length; pos += 32)
+    {
+      auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos));
+      count += _mm_popcnt_u32(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, continuation_max))));
+    }
+    return count;
+  }
+
+  // Decode the leading ASCII characters of a valid UTF-8 encoded string from the specified position 16 bytes at a time using SSE4.2 instructions
+  __attribute__((target("sse4.2")))
+  static void utf8_decode_ascii_sse42(const uint8_t* bytes, size_t length, size_t& pos, std::vector<dauw_rune_t>& runes)
+  {
+    for (; pos + 16 <= length; pos += 16)
+    {
+      auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+      if (_mm_movemask_epi8(input) != 0)
+        return;
+
+      // Widen every group of four bytes to four code points
+      auto offset = runes.size();
+      runes.resize(offset + 16);
+      auto output = reinterpret_cast<__m128i*>(runes.data() + offset);
+      _mm_storeu_si128(output, _mm_cvtepu8_epi32(input));
+      _mm_storeu_si128(output + 1, _mm_cvtepu8_epi32(_mm_srli_si128(input, 4)));
+      _mm_storeu_si128(output + 2, _mm_cvtepu8_epi32(_mm_srli_si128(input, 8)));
+      _mm_storeu_si128(output + 3, _mm_cvtepu8_epi32(_mm_srli_si128(input, 12)));
+    }
+  }
+#endif
+
+  // Return if an array of bytes is a valid UTF-8 encoded string
+  bool utf8_is_valid(const char* bytes, size_t length)
+  {
+    auto data = reinterpret_cast<const uint8_t*>(bytes);
+    size_t pos = 0;
+
+#ifdef DAUW_SIMD_X86
+    // Validate the complete blocks using the widest available instructions
+    static auto validate_blocks = __builtin_cpu_supports("avx2") ? utf8_is_valid_avx2 : __builtin_cpu_supports("sse4.2") ? utf8_is_valid_sse42 : nullptr;
+    if (validate_blocks != nullptr)
+    {
+      if (!validate_blocks(data, length, pos))
+        return false;
+
+      // The blocks may end in the middle of a code point, so validate the remaining bytes from the start of the last code point
+      auto start = pos;
+      while (start > 0 && pos - start < 3 && (data[start - 1] & 0xc0) == 0x80)
+        start --;
+      if (start > 0 && data[start - 1] >= 0xc0)
+        pos = start - 1;
+    }
+#endif
+
+    return utf8_is_valid_scalar(data, length, pos);
+  }
+
+  // Return the number of code points in a valid UTF-8 encoded string
+  size_t utf8_length(const char* bytes, size_t length)
+  {
+    auto data = reinterpret_cast<const uint8_t*>(bytes);
+    size_t pos = 0;
+    size_t count = 0;
+
+#ifdef DAUW_SIMD_X86
+    // Count the code points in the complete blocks using the widest available instructions
+    static auto count_blocks = __builtin_cpu_supports("avx2") ? utf8_length_avx2 : __builtin_cpu_supports("sse4.2") ? utf8_length_sse42 : nullptr;
+    if (count_blocks != nullptr)
+      count += count_blocks(data, length, pos);
+#endif
+
+    return count + utf8_length_scalar(data, length, pos);
+  }
+
+  // Decode a valid UTF-8 encoded string and append its code points to a list of runes
+  void utf8_decode(const char* bytes, size_t length, std::vector<dauw_rune_t>& runes)
+  {
+    auto data = reinterpret_cast<const uint8_t*>(bytes);
+    size_t pos = 0;
+
+#ifdef DAUW_SIMD_X86
+    static auto has_sse42 = __builtin_cpu_supports("sse4.2");
+#endif
+
+    while (pos < length)
+    {
+#ifdef DAUW_SIMD_X86
+      // Decode runs of ASCII characters a block at a time
+      if (has_sse42)
+        utf8_decode_ascii_sse42(data, length, pos, runes);
+      if (pos >= length)
+        break;
+#endif
+
+      // Decode a single code point
+      auto it = bytes + pos;
+      runes.push_back(static_cast<dauw_rune_t>(utf8::next(it, bytes + length)));
+      pos = it - bytes;
+    }
+  }
+
   // Pack a list of runes into a string
   string_t rune_pack_to_str(std::vector<dauw_rune_t> rune_values)
   {
@@ -25,26 +320,31 @@ namespace dauw::utils
   // Unpack a string into a list of runes
   std::vector<dauw_rune_t> rune_unpack_from_str(string_t string)
   {
-    if (!utf8::is_valid(string.cbegin(), string.cend()))
+    if (!utf8_is_valid(string.data(), string.length()))
       throw std::out_of_range(fmt::format("Invalid UTF-8 encoded string '{}'", string));
 
     std::vector<dauw_rune_t> runes;
-    utf8::utf8to32(string.cbegin(), string.cend(), std::back_inserter(runes));
+    runes.reserve(string.length());
+    utf8_decode(string.data(), string.length(), runes);
     return runes;
   }
 
   // Parse a string as an integer
   dauw_int_t parse_int(string_t string)
   {
+    static Regex separator_pattern("_");
+    static Regex hex_pattern("0[Xx]");
+
     // Remove thousand separators from the string
-    string = Regex("_").substitute(string, "");
+    string = separator_pattern.substitute(string, "");
 
     // Check if the string contains a hexadecimal integer
-    auto is_hex_match = Regex("0[Xx]").match(string, 0, REGEX_MATCH_AT_BEGIN);
+    size_t offsets[2];
+    auto is_hex = hex_pattern.match(string, offsets, 1, 0, REGEX_MATCH_AT_BEGIN) > 0;
 
     // Parse the string as an integer
     size_t end_index;
-    auto int_value = (dauw_int_t)std::stoll(string, &end_index, is_hex_match.success() ? 16 : 10);
+    auto int_value = (dauw_int_t)std::stoll(string, &end_index, is_hex ? 16 : 10);
     if (end_index != string.length())
       throw std::invalid_argument(fmt::format("Unexpected character '{}' in integer", string.substr(end_index, 1)));
 
@@ -55,8 +355,10 @@ namespace dauw::utils
   // Parse a string as a float
   dauw_float_t parse_float(string_t string)
   {
+    static Regex separator_pattern("_");
+
     // Remove thousand separators from the string
-    string = Regex("_").substitute(string, "");
+    string = separator_pattern.substitute(string, "");
 
     // Parse the string as a float
     size_t end_index;
@@ -86,23 +388,44 @@ namespace dauw::utils
     return rune_value;
   }
 
-  // Parse a string a a C-string
-  const char* parse_string(string_t string)
+  // Parse a string as a string with its escape sequences replaced
+  string_t parse_string(string_t string)
   {
     // Unescape the string
     string = unescape(string, StringEscapeType::DOUBLE_QUOTED);
 
-    // Return the parsed C-string
-    return string.c_str();
+    // Return the parsed string
+    return string;
   }
 
-  // Parse a string as a regex pattern
-  Regex parse_regex(string_t string)
+  // Parse a regex literal as a pattern with its flags as inline options
+  string_t parse_regex(string_t string)
   {
-    // TODO: Properly parse the regex pattern
+    // Split the literal in the pattern between the delimiters and the trailing flags
+    auto delimiter_index = string.rfind('/');
+    if (string.length() < 2 || string.front() != '/' || delimiter_index == 0)
+      throw std::invalid_argument(fmt::format("Invalid regex literal '{}'", string));
+
+    auto pattern = string.substr(1, delimiter_index - 1);
+    auto flags = string.substr(delimiter_index + 1);
+
+    // Convert the flags to inline options
+    string_t options;
+    for (auto flag : flags)
+    {
+      if (flag != 'i' && flag != 'm' && flag != 's' && flag != 'x')
+        throw std::invalid_argument(fmt::format("Invalid regex flag '{}'", flag));
+      if (options.find(flag) == string_t::npos)
+        options.push_back(flag);
+    }
+    if (!options.empty())
+      pattern = fmt::format("(?{}){}", options, pattern);
+
+    // Compile the pattern to check if it is valid, which also adds it to the pattern cache
+    Regex::cached(pattern);
 
     // Return the parsed regex pattern
-    return Regex(string);
+    return pattern;
   }
 
   // Repeat a string for the specified amount of times
@@ -140,7 +463,7 @@ namespace dauw::utils
       else if (rune == 0x0D)
         result.append("\\r");
       else if (rune <= 0x1F || (rune >= 0x7F && rune <= 0x9F) || (ascii_only && rune >= 0xA0))
-        result.append(fmt::format("\\u{{{}}}"), rune);
+        result.append(fmt::format("\\u{{{:x}}}", rune));
       else
         utf8::append(rune, std::back_inserter(result));
     }
@@ -151,28 +474,57 @@ namespace dauw::utils
   // Convert escape sequences in a string to unprintable characters
   string_t unescape(string_t string, StringEscapeType type)
   {
-    auto escape_pattern = Regex("\\\\(?:(u\\{([0-9A-Fa-f]{1,6})\\})|(\")|(\')|([\\btnfr])|.)");
-    auto escape_matches = escape_pattern.match_all(string);
-    string_t result(string);
+    static Regex escape_pattern("\\\\(?:u\\{([0-9A-Fa-f]{1,6})\\}|(.))");
 
-    for (auto match : escape_matches)
+    string_t result;
+    result.reserve(string.length());
+
+    // Copy the string between the escape sequences and replace the escape sequences
+    size_t offsets[6];
+    size_t pos = 0;
+    while (escape_pattern.match(string, offsets, 3, pos) > 0)
     {
-      string_t result;
-      if (match.group(1).success())
-        result = rune_pack_to_str(parse_rune(match.group(2).value()));
-      else if (match.group(3).success() && type == StringEscapeType::DOUBLE_QUOTED)
-        result = match.group(3).value();
-      else if (match.group(4).success() && type == StringEscapeType::SINGLE_QUOTED)
-        result = match.group(4).value();
-      else if (match.group(5).success())
-        result = match.group(5).value();
-      else
-        throw std::invalid_argument(fmt::format("Invalid escape sequence '{}'", match.value()));
+      result.append(string, pos, offsets[0] - pos);
+      pos = offsets[1];
 
-      string = match.prefix().value() + result + match.suffix().value();
-    }
+      // Unicode escape sequence
+      if (offsets[2] != PCRE2_UNSET)
+      {
+        try
+        {
+          auto rune = static_cast<dauw_rune_t>(std::stoul(string.substr(offsets[2], offsets[3] - offsets[2]), nullptr, 16));
+          utf8::append(rune, std::back_inserter(result));
+          continue;
+        }
+        catch (utf8::invalid_code_point& ex)
+        {
+          throw std::invalid_argument(fmt::format("Invalid code point in escape sequence '{}'", string.substr(offsets[0], offsets[1] - offsets[0])));
+        }
+      }
 
+      // Single character escape sequence
+      auto escaped = string[offsets[4]];
+      if (escaped == '\\')
+        result.push_back('\\');
+      else if (escaped == '"' && type == StringEscapeType::DOUBLE_QUOTED)
+        result.push_back('"');
+      else if (escaped == '\'' && type == StringEscapeType::SINGLE_QUOTED)
+        result.push_back('\'');
+      else if (escaped == 'b')
+        result.push_back('\b');
+      else if (escaped == 't')
+        result.push_back('\t');
+      else if (escaped == 'n')
+        result.push_back('\n');
+      else if (escaped == 'f')
+        result.push_back('\f');
+      else if (escaped == 'r')
+        result.push_back('\r');
+      else
+        throw std::invalid_argument(fmt::format("Invalid escape sequence '{}'", string.substr(offsets[0], offsets[1] - offsets[0])));
+    }
 
-    return string;
+    result.append(string, pos, string_t::npos);
+    return result;
   }
 }
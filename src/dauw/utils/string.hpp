@@ -13,6 +13,15 @@ namespace dauw::utils
   };
 
 
+  // Return if an array of bytes is a valid UTF-8 encoded string
+  bool utf8_is_valid(const char* bytes, size_t length);
+
+  // Return the number of code points in a valid UTF-8 encoded string
+  size_t utf8_length(const char* bytes, size_t length);
+
+  // Decode a valid UTF-8 encoded string and append its code points to a list of runes
+  void utf8_decode(const char* bytes, size_t length, std::vector<dauw_rune_t>& runes);
+
   // Pack a list of runes into a string
   string_t rune_pack_to_str(std::vector<dauw_rune_t> rune_values);
   string_t rune_pack_to_str(std::initializer_list<dauw_rune_t> rune_values);
@@ -25,8 +34,8 @@ namespace dauw::utils
   dauw_int_t parse_int(string_t string);
   dauw_float_t parse_float(string_t string);
   dauw_rune_t parse_rune(string_t string);
-  const char* parse_string(string_t string);
-  //Regex parse_regex(string_t string);
+  string_t parse_string(string_t string);
+  string_t parse_regex(string_t string);
 
   // Repeat a string for the specified amount of times
   string_t repeat(string_t string, size_t times);
@@ -35,21 +35,25 @@ void print_usage(int argc, const char* argv[])
 
 	fmt::print(fmt::emphasis::bold | fmt::emphasis::underline, "Optional arguments");
 	fmt::print("\n\n");
-	fmt::print("  -h, --help      Show this help message and exit.\n\n");
+	fmt::print("  -h, --help      Show this help message and exit.\n");
+	fmt::print("  -i, --interpret Evaluate the code using the tree-walking interpreter instead\n");
+	fmt::print("                  of compiling it to bytecode for the virtual machine.\n");
+	fmt::print("  -n, --no-cache  Compile the source code even if cached bytecode of the file\n");
+	fmt::print("                  is available, and don't write the bytecode to the cache.\n\n");
 }
 
 // Main function
 int main(int argc, const char* argv[])
 {
-  // Create the interpreter
-	auto app = std::make_shared<dauw::Dauw>();
-
 	// Parse the arguments
 	argh::parser cmdl;
 	cmdl.add_params({"-h", "--help"});
 	cmdl.add_params({"-v", "--version"});
 	cmdl.parse(argc, argv, argh::parser::SINGLE_DASH_IS_MULTIFLAG);
 
+  // Create the interpreter
+	auto app = std::make_shared<dauw::Dauw>(cmdl[{"-i", "--interpret"}], !cmdl[{"-n", "--no-cache"}]);
+
 	// Handle the parsed arguments
 	if (cmdl[{"-h", "--help"}])
 	{
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+
+import colorama
+import os
+import os.path
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+from argparse import ArgumentParser
+from colorama import Fore, Back, Style
+
+from utils import s, divider
+
+
+# Class that defines a benchmark
+class Benchmark:
+  # Pattern for the instruction count that is printed by builds that count dispatched instructions
+  _instruction_count_pattern = re.compile(r"Dispatched (\d+) instructions")
+
+
+  # Constructor
+  def __init__(self, path):
+    self.path = path
+
+  # Return a string representation for the benchmark
+  def __str__(self):
+    return "benchmark " + Style.BRIGHT + os.path.basename(self.path) + Style.NORMAL
+
+  # Run the benchmark with the specified interpreter and return the durations of the runs and the number of dispatched instructions, if the interpreter counts them
+  def __call__(self, interpreter_path, runs):
+    durations = []
+    instructions = None
+    for _ in range(runs):
+      # Run the subprocess without the bytecode cache and measure the time it takes to execute
+      start = time.perf_counter()
+      result = subprocess.run([interpreter_path, "--no-cache", self.path], stdout = subprocess.DEVNULL, stderr = subprocess.PIPE, text = True)
+      end = time.perf_counter()
+
+      if result.returncode != 0:
+        raise RuntimeError(f"{interpreter_path} exited with code {result.returncode}")
+      durations.append(end - start)
+
+      if match := self._instruction_count_pattern.search(result.stderr):
+        instructions = int(match.group(1))
+
+    return durations, instructions
+
+
+# Class that runs a benchmark suite
+class Runner:
+  # Constructor
+  def __init__(self, interpreter_paths, runs):
+    self.interpreter_paths = interpreter_paths
+    self.runs = runs
+
+  # Run the benchmark in the file at the specified path
+  def benchmark_file(self, path):
+    # Create the benchmark from the file
+    benchmark = Benchmark(os.path.abspath(path))
+    print(Style.BRIGHT + f"Running {benchmark} {self.runs} time{s(self.runs)}:")
+
+    # Run the benchmark for every interpreter and compare the fastest runs against the first interpreter
+    baseline = None
+    baseline_instructions = None
+    for interpreter_path in self.interpreter_paths:
+      try:
+        durations, instructions = benchmark(interpreter_path, self.runs)
+      except RuntimeError as ex:
+        print(Fore.RED + f"  {ex}")
+        continue
+
+      best = min(durations)
+      median = statistics.median(durations)
+      if baseline is None:
+        baseline = best
+
+      print(f"  {interpreter_path:<40} " + Style.BRIGHT + f"{best * 1000:>8.1f} ms" + Style.RESET_ALL + Style.DIM + f" (median {median * 1000:.1f} ms)" + Style.RESET_ALL, end = "")
+      if baseline != best:
+        color = Fore.GREEN if best < baseline else Fore.RED
+        print(color + f" {baseline / best:.2f}x", end = "")
+      print()
+
+      # Print the number of dispatched instructions if the interpreter counts them
+      if instructions is not None:
+        if baseline_instructions is None:
+          baseline_instructions = instructions
+        print(Style.DIM + f"  {'':<40} {instructions:>11,d} instructions dispatched" + Style.RESET_ALL, end = "")
+        if baseline_instructions != instructions:
+          print(Style.DIM + f" ({instructions / baseline_instructions:.0%} of the first)" + Style.RESET_ALL, end = "")
+        print()
+
+    divider()
+
+    # Return self for chainability
+    return self
+
+  # Run the benchmarks in the directory at the specified path
+  def benchmark_directory(self, path):
+    # Iterate over the the directory and run the benchmarks
+    for entry in sorted(os.listdir(path)):
+      self.benchmark(os.path.join(path, entry))
+
+    # Return self for chainability
+    return self
+
+  # Run the benchmarks in the file or directory at the specified path
+  def benchmark(self, path):
+    path = os.path.abspath(path)
+    if os.path.isdir(path):
+      return self.benchmark_directory(path)
+    elif os.path.isfile(path) and path.endswith(".dauw"):
+      return self.benchmark_file(path)
+
+
+# Main function
+def main(args):
+  # Initialize colorama
+  colorama.init(autoreset = True)
+
+  # Parse the command line arguments
+  parser = ArgumentParser(prog = "benchmark.py", description = "Run the benchmarks for the Dauw virtual machine and compare interpreter builds, for example a build with computed goto dispatch against one with switch dispatch. Builds with DAUW_VM_COUNT_INSTRUCTIONS also report the number of dispatched instructions.")
+  parser.add_argument("suite", action = "store", help = "path to the benchmark suite")
+  parser.add_argument("-p", "--path", action = "append", help = "path to an interpreter executable, which can be specified multiple times to compare against the first one (defaults to './dauw')")
+  parser.add_argument("-r", "--runs", action = "store", type = int, default = 5, help = "number of runs per benchmark, of which the fastest one is reported (defaults to 5)")
+
+  args = parser.parse_args(args)
+  paths = args.path or ["./dauw"]
+
+  # Check the arguments
+  if not os.path.exists(args.suite):
+    print(f"Cannot run the benchmarks: the benchmark suite path \"{args.suite}\" does not exist")
+    sys.exit(1)
+  for path in paths:
+    if not os.path.exists(path) or not os.path.isfile(path):
+      print(f"Cannot run the benchmarks: the interpreter path \"{path}\" does not exist or is not a file")
+      sys.exit(1)
+
+  # Create a benchmark runner and run the benchmarks in the suite
+  Runner(paths, max(args.runs, 1)).benchmark(os.path.abspath(args.suite))
+
+
+# Execute the main function
+if __name__ == "__main__":
+  main(sys.argv[1:])